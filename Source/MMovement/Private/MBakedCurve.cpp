@@ -0,0 +1,36 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MBakedCurve.h"
+
+#include "Curves/CurveFloat.h"
+
+void FMBakedCurve::Bake(const UCurveFloat* Curve, int32 SampleCount)
+{
+	Samples.Reset();
+	TimeMin = 0;
+	SamplesPerSecond = 0;
+
+	if (Curve == nullptr)
+		return;
+
+	float TimeMax;
+	Curve->GetTimeRange(TimeMin, TimeMax);
+
+	// Curve with a single key (or no keys) is constant
+	const float TimeRange = TimeMax - TimeMin;
+	if (TimeRange <= UE_KINDA_SMALL_NUMBER)
+	{
+		Samples.Add(Curve->GetFloatValue(TimeMin));
+		return;
+	}
+
+	SampleCount = FMath::Max(SampleCount, 2);
+	SamplesPerSecond = (SampleCount - 1) / TimeRange;
+
+	Samples.SetNumUninitialized(SampleCount);
+	for (int32 SampleIndex = 0; SampleIndex < SampleCount; ++SampleIndex)
+	{
+		Samples[SampleIndex] = Curve->GetFloatValue(TimeMin + SampleIndex / SamplesPerSecond);
+	}
+}
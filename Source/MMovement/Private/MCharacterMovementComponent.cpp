@@ -5,14 +5,21 @@
 
 #include "MControlledLaunchAsset.h"
 #include "MControlledLaunchManager.h"
+#include "MControlledLaunchSubsystem.h"
 #include "MDebug.h"
 #include "MMath.h"
 #include "MMovementMode_Base.h"
-#include "MMovementMode_OrientToMovementInterface.h"
 #include "MMovementTypes.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/Character.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ground Probe Traces"), STAT_MMovement_GroundProbeTraces, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Ground Probe Reuses"), STAT_MMovement_GroundProbeReuses, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Move With Snap Single Sweeps"), STAT_MMovement_MoveWithSnapSingleSweeps, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Move With Snap Fallbacks"), STAT_MMovement_MoveWithSnapFallbacks, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Movement State Resolves"), STAT_MMovement_MovementStateResolves, STATGROUP_MMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sleeping Movement Components"), STAT_MMovement_SleepingMovementComponents, STATGROUP_MMovement);
+
 UMCharacterMovementComponent::UMCharacterMovementComponent()
 {
 }
@@ -23,6 +30,8 @@ void UMCharacterMovementComponent::BeginPlay()
 
 	ControlledLaunchManager = NewObject<UMControlledLaunchManager>(this, TEXT("ControlledLaunchManager"));
 
+	BuildSpeedConfigTable();
+
 	// Apply initial walking type
 
 	[this]
@@ -42,11 +51,41 @@ void UMCharacterMovementComponent::BeginPlay()
 
 	ControlledLaunchManager->Initialize(this);
 
+	if (bTickControlledLaunchesInSubsystem)
+	{
+		if (UMControlledLaunchSubsystem* ControlledLaunchSubsystem = GetWorld()->GetSubsystem<UMControlledLaunchSubsystem>())
+			ControlledLaunchSubsystem->RegisterMovementComponent(this);
+	}
+
+	InitializeSignalHistories();
+
+	GroundProbeQueryParams.AddIgnoredActor(GetOwner());
+
 	EnsureMovementModesInitialized();
 }
 
+void UMCharacterMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bTickControlledLaunchesInSubsystem)
+	{
+		if (UMControlledLaunchSubsystem* ControlledLaunchSubsystem = GetWorld()->GetSubsystem<UMControlledLaunchSubsystem>())
+			ControlledLaunchSubsystem->UnregisterMovementComponent(this);
+	}
+
+	WakeMovement();
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void UMCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
+	UpdateMovementSleep();
+	if (bMovementSleeping)
+	{
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+		return;
+	}
+
 	// Cache input vector so it can be used in other contexts
 	MovementInputVectorLast = GetPendingInputVector();
 	if (!MovementInputVectorLast.IsNearlyZero())
@@ -55,11 +94,13 @@ void UMCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick Tic
 	// Manage controlled launch and apply multipliers
 	if (IsValid(ControlledLaunchManager))
 	{
-		ControlledLaunchManager->TickLaunches(DeltaTime);
+		// Already ticked in UMControlledLaunchSubsystem batch this frame
+		if (!ControlledLaunchManager->IsTickedBySubsystem())
+			ControlledLaunchManager->TickLaunches(DeltaTime);
 
 		const FMControlledLaunchManager_ProcessResult ControlledLaunchResult = ControlledLaunchManager->Process(Acceleration);
 
-		const FMCharacterMovementWalkingSpeedConfig& SpeedConfig = GetCurrentWalkingSpeedConfig();
+		const FMCharacterMovementWalkingSpeedConfig& SpeedConfig = SpeedConfigResolved;
 
 		BrakingDecelerationWalking = SpeedConfig.BrakingDeceleration * ControlledLaunchResult.BrakingDecelerationMultiplier;
 		BrakingDecelerationFalling = DefaultValues.BrakingDecelerationFalling * ControlledLaunchResult.BrakingDecelerationMultiplier;
@@ -69,58 +110,141 @@ void UMCharacterMovementComponent::TickComponent(float DeltaTime, ELevelTick Tic
 
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	UpdateTemporalHorizontalVelocityEntry();
+	UpdateSignalHistories();
 
 	// Tick Movement Modes
 	for (UMMovementMode_Base* CustomMovementModeInstance : CustomMovementModeInstances)
 	{
-		CustomMovementModeInstance->Tick(DeltaTime);
+		CustomMovementModeInstance->DispatchTick(DeltaTime);
+	}
+}
+
+void UMCharacterMovementComponent::WakeMovement()
+{
+	IdleFrameCount = 0;
+
+	if (!bMovementSleeping)
+		return;
+
+	bMovementSleeping = false;
+	SleepMovementBase = nullptr;
+	DEC_DWORD_STAT(STAT_MMovement_SleepingMovementComponents);
+}
+
+void UMCharacterMovementComponent::UpdateMovementSleep()
+{
+	if (!bSleepWhenIdle)
+		return;
+
+	if (bMovementSleeping)
+	{
+		const UPrimitiveComponent* MovementBaseCurrent = GetMovementBase();
+		const bool bMovementBaseMoved = MovementBaseCurrent != SleepMovementBase
+			|| (MovementBaseCurrent != nullptr && !MovementBaseCurrent->GetComponentTransform().Equals(SleepMovementBaseTransform));
+
+		if (bMovementBaseMoved || !IsIdleFrame())
+			WakeMovement();
+
+		return;
+	}
+
+	if (!IsIdleFrame())
+	{
+		IdleFrameCount = 0;
+		return;
 	}
+
+	// Modes are asked only once the character was idle long enough
+	if (++IdleFrameCount < IdleFramesToSleep || !CanMovementModesSleep())
+		return;
+
+	bMovementSleeping = true;
+	SleepMovementBase = GetMovementBase();
+	SleepMovementBaseTransform = SleepMovementBase != nullptr ? SleepMovementBase->GetComponentTransform() : FTransform::Identity;
+	INC_DWORD_STAT(STAT_MMovement_SleepingMovementComponents);
+}
+
+bool UMCharacterMovementComponent::IsIdleFrame() const
+{
+	if (IsCurrentMovementModeCustom() || !IsMovingOnGround())
+		return false;
+
+	if (!Velocity.IsNearlyZero() || !GetPendingInputVector().IsNearlyZero())
+		return false;
+
+	if (!PendingLaunchVelocity.IsNearlyZero() || !PendingImpulseToApply.IsNearlyZero() || !PendingForceToApply.IsNearlyZero())
+		return false;
+
+	return !IsValid(ControlledLaunchManager) || !ControlledLaunchManager->IsAnyControlledLaunchActive();
+}
+
+bool UMCharacterMovementComponent::CanMovementModesSleep() const
+{
+	for (const UMMovementMode_Base* CustomMovementModeInstance : CustomMovementModeInstances)
+	{
+		if (!CustomMovementModeInstance->AllowsMovementSleep())
+			return false;
+	}
+
+	return true;
 }
 
 FRotator UMCharacterMovementComponent::ComputeOrientToMovementRotation(const FRotator& CurrentRotation, float DeltaTime,
                                                                        FRotator& DeltaRotation) const
 {
-	// Compute for custom movement mode if it implements ISKMovementMode_OrientToMovementInterface
+	// Compute for custom movement mode if it implements IMMovementMode_OrientToMovementInterface
 	UMMovementMode_Base* CustomMovementModeCurrent = GetActiveCustomMovementModeInstance();
-	if (IsValid(CustomMovementModeCurrent) && CustomMovementModeCurrent->Implements<UMMovementMode_OrientToMovementInterface>())
+	if (IsValid(CustomMovementModeCurrent) && CustomMovementModeCurrent->ImplementsOrientToMovementInterface())
 	{
-		return IMMovementMode_OrientToMovementInterface::Execute_ComputeOrientToMovementRotation(
-			CustomMovementModeCurrent, CurrentRotation, DeltaTime, DeltaRotation);
+		return CustomMovementModeCurrent->DispatchComputeOrientToMovementRotation(CurrentRotation, DeltaTime, DeltaRotation);
 	}
 
 	return ComputeCharacterOrientation(CurrentRotation, DeltaTime, DeltaRotation);
 }
 
-void UMCharacterMovementComponent::AddControlledLaunchFromParams(const FVector& LaunchVelocity,
-                                                                 const FMControlledLaunchParams& LaunchParams,
-                                                                 UObject* Owner)
+FMControlledLaunchHandle UMCharacterMovementComponent::AddControlledLaunchFromParams(const FVector& LaunchVelocity,
+                                                                                     const FMControlledLaunchParams& LaunchParams,
+                                                                                     UObject* Owner)
 {
 	if (!IsValid(ControlledLaunchManager))
 	{
-		return;
+		return FMControlledLaunchHandle();
 	}
 
-	ControlledLaunchManager->AddControlledLaunch(LaunchVelocity, LaunchParams, Owner);
+	WakeMovement();
+
+	return ControlledLaunchManager->AddControlledLaunch(LaunchVelocity, LaunchParams, Owner);
 }
 
-void UMCharacterMovementComponent::AddControlledLaunchFromAsset(const FVector& LaunchVelocity, const UMControlledLaunchAsset* LaunchAsset,
-                                                                UObject* Owner)
+FMControlledLaunchHandle UMCharacterMovementComponent::AddControlledLaunchFromAsset(const FVector& LaunchVelocity,
+                                                                                    const UMControlledLaunchAsset* LaunchAsset,
+                                                                                    UObject* Owner)
 {
-	AddControlledLaunchFromParams(LaunchVelocity, LaunchAsset->LaunchParams, Owner);
+	if (!IsValid(ControlledLaunchManager))
+	{
+		return FMControlledLaunchHandle();
+	}
+
+	WakeMovement();
+
+	return ControlledLaunchManager->AddControlledLaunchFromAsset(LaunchVelocity, LaunchAsset, Owner);
+}
+
+bool UMCharacterMovementComponent::CancelControlledLaunch(const FMControlledLaunchHandle Handle)
+{
+	return IsValid(ControlledLaunchManager) && ControlledLaunchManager->CancelControlledLaunch(Handle);
+}
+
+bool UMCharacterMovementComponent::IsControlledLaunchActive(const FMControlledLaunchHandle Handle) const
+{
+	return IsValid(ControlledLaunchManager) && ControlledLaunchManager->IsControlledLaunchActive(Handle);
 }
 
 UMMovementMode_Base* UMCharacterMovementComponent::GetCustomMovementModeInstance(
 	const TSubclassOf<UMMovementMode_Base> MovementModeClass) const
 {
-	for (const auto MovementModeInstance : CustomMovementModeInstances)
-	{
-		const UClass* CommonBaseClass = UClass::FindCommonBase(MovementModeClass, MovementModeInstance->GetClass());
-		if (CommonBaseClass == MovementModeClass)
-			return MovementModeInstance;
-	}
-
-	return nullptr;
+	UMMovementMode_Base* const* MovementModeInstance = MovementModeRegistry.Find(MovementModeClass.Get());
+	return MovementModeInstance != nullptr ? *MovementModeInstance : nullptr;
 }
 
 FVector UMCharacterMovementComponent::GetHorizontalVelocity() const
@@ -133,29 +257,41 @@ FVector UMCharacterMovementComponent::GetHorizontalVelocity() const
 
 FVector UMCharacterMovementComponent::GetPeakTemporalHorizontalVelocity() const
 {
-	FVector VelocityResult = GetHorizontalVelocity();
-	float SpeedMax = VelocityResult.Size2D();
-	for (const FVector& TemporalVelocity : TemporalHorizontalVelocityArray)
-	{
-		const float Speed = TemporalVelocity.Size2D();
-		if (Speed > SpeedMax)
-		{
-			VelocityResult = TemporalVelocity;
-			SpeedMax = Speed;
-		}
-	}
+	// Current velocity may not be in history yet
+	const FVector HorizontalVelocity = GetHorizontalVelocity();
+
+	const FMMovementSignalHistory& History = SignalHistories[static_cast<uint8>(EMMovementSignal::HorizontalSpeed)];
+	const FMMovementSignalHistory::FSample* Peak = History.GetPeak();
+	if (Peak != nullptr && Peak->Value > HorizontalVelocity.Size2D())
+		return Peak->Vector;
+
+	return HorizontalVelocity;
+}
 
-	return VelocityResult;
+float UMCharacterMovementComponent::GetPeakTemporalSignalValue(const EMMovementSignal Signal) const
+{
+	const uint8 SignalIndex = static_cast<uint8>(Signal);
+	if (SignalIndex >= static_cast<uint8>(EMMovementSignal::MAX))
+		return 0;
+
+	const FMMovementSignalHistory::FSample* Peak = SignalHistories[SignalIndex].GetPeak();
+	return Peak != nullptr ? Peak->Value : 0;
 }
 
 bool UMCharacterMovementComponent::IsMovingOnSurface() const
+{
+	return GetCachedMovementState(EMMovementStateCacheFlags::MovingOnSurfaceResolved, EMMovementStateCacheFlags::MovingOnSurface,
+	                              &UMCharacterMovementComponent::ResolveIsMovingOnSurface);
+}
+
+bool UMCharacterMovementComponent::ResolveIsMovingOnSurface() const
 {
 	if (IsCurrentMovementModeCustom())
 	{
 		UMMovementMode_Base* ActiveCustomMovementModeInstance = GetActiveCustomMovementModeInstance();
 		if (IsValid(ActiveCustomMovementModeInstance))
 		{
-			return ActiveCustomMovementModeInstance->IsMovingOnSurface();
+			return ActiveCustomMovementModeInstance->DispatchIsMovingOnSurface();
 		}
 	}
 
@@ -164,7 +300,7 @@ bool UMCharacterMovementComponent::IsMovingOnSurface() const
 
 void UMCharacterMovementComponent::ClearTemporalHorizontalVelocity()
 {
-	TemporalHorizontalVelocityArray.Empty();
+	SignalHistories[static_cast<uint8>(EMMovementSignal::HorizontalSpeed)].Clear();
 }
 
 FVector UMCharacterMovementComponent::GetDirectionAlongFloorForDirection(const FVector& Direction) const
@@ -172,6 +308,126 @@ FVector UMCharacterMovementComponent::GetDirectionAlongFloorForDirection(const F
 	return MMath::GetDirectorAlongSurfaceForDirection(CurrentFloor.HitResult.ImpactNormal, Direction);
 }
 
+const FMMovementGroundProbeResult& UMCharacterMovementComponent::ProbeGround(const float MaxDistance) const
+{
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+
+	// Probed this or last frame from above on the same vertical line, segment below is part of the probed one.
+	// Frame of the probe is kept on reuse, so ground changes are picked up at least every other frame
+	const bool bProbedRecently = GroundProbeFrame != MAX_uint64 && GFrameCounter - GroundProbeFrame <= 1;
+	const float Descent = GroundProbeLocation.Z - Location.Z;
+	if (bProbedRecently && Descent >= -KINDA_SMALL_NUMBER
+		&& FVector2D(Location).Equals(FVector2D(GroundProbeLocation), KINDA_SMALL_NUMBER * 100))
+	{
+		const bool bGroundBelow = GroundProbeResult.bHit && GroundProbeResult.Distance - Descent >= 0;
+		const bool bTracedFarEnough = !GroundProbeResult.bHit && MaxDistance <= GroundProbeTracedDistance - Descent;
+		if (bGroundBelow || bTracedFarEnough)
+		{
+			GroundProbeLocation = Location;
+			GroundProbeTracedDistance -= Descent;
+			GroundProbeResult.Distance -= Descent;
+			GroundProbeResult.Hit.TraceStart = Location;
+			GroundProbeResult.Hit.Distance -= Descent;
+
+			INC_DWORD_STAT(STAT_MMovement_GroundProbeReuses);
+			return GroundProbeResult;
+		}
+	}
+
+	GroundProbeFrame = GFrameCounter;
+	GroundProbeLocation = Location;
+	GroundProbeResult = FMMovementGroundProbeResult();
+
+	// Floor found by FindFloor from this location, ground directly below is on the floor plane
+	if ((MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking) && CurrentFloor.IsWalkableFloor()
+		&& FVector::PointsAreNear(CurrentFloor.HitResult.TraceStart, Location, KINDA_SMALL_NUMBER * 100))
+	{
+		const FVector FloorNormal = CurrentFloor.HitResult.ImpactNormal;
+		if (FloorNormal.Z > KINDA_SMALL_NUMBER)
+		{
+			const FVector GroundPoint = FMath::LinePlaneIntersection(Location, Location + FVector::DownVector,
+			                                                         CurrentFloor.HitResult.ImpactPoint, FloorNormal);
+
+			GroundProbeResult.bHit = true;
+			GroundProbeResult.bFromCurrentFloor = true;
+			GroundProbeResult.Distance = Location.Z - GroundPoint.Z;
+			GroundProbeResult.Hit = CurrentFloor.HitResult;
+			GroundProbeResult.Hit.ImpactPoint = GroundPoint;
+			GroundProbeResult.Hit.Location = GroundPoint;
+			GroundProbeResult.Hit.Normal = FloorNormal;
+
+			// Floor can be further than anything registered, it answers queries of any distance
+			GroundProbeTracedDistance = MAX_flt;
+
+			INC_DWORD_STAT(STAT_MMovement_GroundProbeReuses);
+			return GroundProbeResult;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_MMovement_GroundProbeTraces);
+	GroundProbeTraceCount++;
+
+	GroundProbeTracedDistance = FMath::Max(MaxDistance, GroundProbeDistance);
+
+	FHitResult Hit;
+	const FVector TraceEnd = Location + FVector::DownVector * GroundProbeTracedDistance;
+	if (GroundProbeQueryConfig.LineTraceSingle(GetWorld(), Hit, Location, TraceEnd, GroundProbeQueryParams))
+	{
+		GroundProbeResult.bHit = true;
+		GroundProbeResult.Distance = Location.Z - Hit.ImpactPoint.Z;
+		GroundProbeResult.Hit = Hit;
+	}
+
+	return GroundProbeResult;
+}
+
+void UMCharacterMovementComponent::RegisterGroundProbeDistance(const float MaxDistance)
+{
+	GroundProbeDistance = FMath::Max(GroundProbeDistance, MaxDistance);
+}
+
+bool UMCharacterMovementComponent::SafeMoveUpdatedComponentWithSnap(const FVector& Delta, const float DeltaTime,
+                                                                    TFunctionRef<FVector(const FVector& Location)> CalculateSnapDelta,
+                                                                    FHitResult& OutHit)
+{
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+	const FVector CombinedDelta = Delta + CalculateSnapDelta(UpdatedComponent->GetComponentLocation() + Delta);
+
+	{
+		// Deferred, so the reverted combined sweep doesn't update overlaps
+		FScopedMovementUpdate ScopedMovementUpdate(UpdatedComponent, EScopedUpdate::DeferredUpdates);
+
+		SafeMoveUpdatedComponent(CombinedDelta, Rotation, true, OutHit);
+		if (!OutHit.IsValidBlockingHit())
+		{
+			INC_DWORD_STAT(STAT_MMovement_MoveWithSnapSingleSweeps);
+			return true;
+		}
+
+		ScopedMovementUpdate.RevertMove();
+	}
+
+	INC_DWORD_STAT(STAT_MMovement_MoveWithSnapFallbacks);
+
+	OutHit = FHitResult(1.f);
+	SafeMoveUpdatedComponent(Delta, Rotation, true, OutHit);
+
+	if (OutHit.Time < 1.f)
+	{
+		HandleImpact(OutHit, DeltaTime, Delta);
+		SlideAlongSurface(Delta, (1.0f - OutHit.Time), OutHit.Normal, OutHit, true);
+	}
+
+	const FVector SnapDelta = CalculateSnapDelta(UpdatedComponent->GetComponentLocation());
+	if (!SnapDelta.IsNearlyZero())
+	{
+		constexpr bool bSweep = true;
+		UpdatedComponent->MoveComponent(SnapDelta, Rotation, bSweep);
+	}
+
+	return false;
+}
+
 void UMCharacterMovementComponent::HandleImpact(const FHitResult& Hit, float TimeSlice, const FVector& MoveDelta)
 {
 	Super::HandleImpact(Hit, TimeSlice, MoveDelta);
@@ -273,11 +529,17 @@ void UMCharacterMovementComponent::GrabDebugSnapshot(struct FVisualLogEntry* Sna
 #endif
 
 bool UMCharacterMovementComponent::IsMovingOnGround() const
+{
+	return GetCachedMovementState(EMMovementStateCacheFlags::MovingOnGroundResolved, EMMovementStateCacheFlags::MovingOnGround,
+	                              &UMCharacterMovementComponent::ResolveIsMovingOnGround);
+}
+
+bool UMCharacterMovementComponent::ResolveIsMovingOnGround() const
 {
 	UMMovementMode_Base* ActiveCustomMovementMode = GetActiveCustomMovementModeInstance();
 	if (IsValid(ActiveCustomMovementMode))
 	{
-		return ActiveCustomMovementMode->IsMovingOnGround();
+		return ActiveCustomMovementMode->DispatchIsMovingOnGround();
 	}
 
 	return Super::IsMovingOnGround();
@@ -288,10 +550,25 @@ bool UMCharacterMovementComponent::IsFalling() const
 	return !IsMovingOnSurface();
 }
 
+bool UMCharacterMovementComponent::GetCachedMovementState(const EMMovementStateCacheFlags ResolvedFlag,
+                                                          const EMMovementStateCacheFlags ValueFlag,
+                                                          bool (UMCharacterMovementComponent::*Resolve)() const) const
+{
+	if (!EnumHasAnyFlags(MovementStateCache, ResolvedFlag))
+	{
+		INC_DWORD_STAT(STAT_MMovement_MovementStateResolves);
+
+		// Resolve may query other cached states (e.g., base CanCrouchInCurrentState checks IsFalling), so flags are set after it
+		const bool bValue = (this->*Resolve)();
+		MovementStateCache |= bValue ? ResolvedFlag | ValueFlag : ResolvedFlag;
+	}
+
+	return EnumHasAnyFlags(MovementStateCache, ValueFlag);
+}
+
 float UMCharacterMovementComponent::GetMaxSpeed() const
 {
-	const FMCharacterMovementWalkingSpeedConfig WalkingSpeedConfig = GetCurrentWalkingSpeedConfig();
-	return WalkingSpeedConfig.Speed;
+	return SpeedConfigResolved.Speed;
 }
 
 void UMCharacterMovementComponent::Reset_Implementation(bool bHardReset)
@@ -314,7 +591,13 @@ void UMCharacterMovementComponent::Reset_Implementation(bool bHardReset)
 		}
 	}
 
-	ClearTemporalHorizontalVelocity();
+	InvalidateMovementStateCache();
+	WakeMovement();
+
+	for (FMMovementSignalHistory& SignalHistory : SignalHistories)
+	{
+		SignalHistory.Clear();
+	}
 }
 
 void UMCharacterMovementComponent::EnsureMovementModesInitialized()
@@ -340,17 +623,185 @@ void UMCharacterMovementComponent::EnsureMovementModesInitialized()
 	{
 		UMMovementMode_Base* CustomMovementModeInstance = NewObject<UMMovementMode_Base>(this, MovementModeClass);
 		CustomMovementModeInstance->Initialize(GetCharacterOwner(), this);
+		CustomMovementModeInstance->BuildDispatchTable();
 
 		CustomMovementModeInstances.Emplace(CustomMovementModeInstance);
 	}
 
+	BuildMovementModeRegistry();
+	BuildMovementModeTransitionMatrix();
+	InvalidateMovementStateCache();
+
 	bMovementModesInitialized = true;
+
+	for (UMMovementMode_Base* CustomMovementModeInstance : CustomMovementModeInstances)
+	{
+		CustomMovementModeInstance->OnMovementModesRegistered();
+	}
+}
+
+void UMCharacterMovementComponent::BuildMovementModeRegistry()
+{
+	MovementModeRegistry.Reset();
+	CustomMovementModeInstancesByByte.Reset();
+
+	if (CustomMovementModeInstances.Num() > MaxCustomMovementModes)
+	{
+		M::Debug::LogUserError(LogMMovement, FString::Printf(
+			                       TEXT("AvailableMovementModes has %d movement modes, only the first %d are used"),
+			                       CustomMovementModeInstances.Num(), MaxCustomMovementModes), GetOwner());
+		CustomMovementModeInstances.SetNum(MaxCustomMovementModes);
+	}
+
+	for (int32 Slot = 0; Slot < CustomMovementModeInstances.Num(); ++Slot)
+	{
+		CustomMovementModeInstances[Slot]->SetMovementModeSlot(Slot);
+	}
+
+	// Parent classes resolve to the first registered subclass, so lookups by parent class keep priority order
+	for (UMMovementMode_Base* CustomMovementModeInstance : CustomMovementModeInstances)
+	{
+		const UClass* MovementModeClass = CustomMovementModeInstance->GetClass();
+		if (MovementModeRegistry.Contains(MovementModeClass))
+		{
+			M::Debug::LogUserError(LogMMovement, FString::Printf(
+				                       TEXT("Movement mode %s is added more than once to AvailableMovementModes, lookups resolve to the first one"),
+				                       *GetNameSafe(MovementModeClass)), GetOwner());
+		}
+
+		for (const UClass* Class = MovementModeClass; Class != nullptr; Class = Class->GetSuperClass())
+		{
+			MovementModeRegistry.FindOrAdd(Class, CustomMovementModeInstance);
+
+			if (Class == UMMovementMode_Base::StaticClass())
+				break;
+		}
+	}
+
+	// Modes run as their reserved EMCustomMovementMode value, so it means the same mode regardless of AvailableMovementModes order
+	const UEnum* CustomMovementModeEnum = StaticEnum<EMCustomMovementMode>();
+	TArray<UMMovementMode_Base*, TInlineAllocator<8>> UnreservedMovementModes;
+	for (UMMovementMode_Base* CustomMovementModeInstance : CustomMovementModeInstances)
+	{
+		CustomMovementModeInstance->SetCustomMovementModeByte(INDEX_NONE);
+
+		const int32 ReservedByte = CustomMovementModeInstance->GetReservedCustomMovementMode();
+		if (ReservedByte == INDEX_NONE)
+		{
+			UnreservedMovementModes.Add(CustomMovementModeInstance);
+			continue;
+		}
+
+		if (!CustomMovementModeEnum->IsValidEnumValue(ReservedByte))
+		{
+			M::Debug::LogUserError(LogMMovement, FString::Printf(
+				                       TEXT("Movement mode %s reserves custom movement mode %d which is not in EMCustomMovementMode"),
+				                       *CustomMovementModeInstance->GetMovementModeName().ToString(), ReservedByte), GetOwner());
+			UnreservedMovementModes.Add(CustomMovementModeInstance);
+			continue;
+		}
+
+		if (CustomMovementModeInstancesByByte.IsValidIndex(ReservedByte) && CustomMovementModeInstancesByByte[ReservedByte] != nullptr)
+		{
+			M::Debug::LogUserError(LogMMovement, FString::Printf(
+				                       TEXT("Movement modes %s and %s both reserve custom movement mode %s"),
+				                       *CustomMovementModeInstancesByByte[ReservedByte]->GetMovementModeName().ToString(),
+				                       *CustomMovementModeInstance->GetMovementModeName().ToString(),
+				                       *CustomMovementModeEnum->GetNameStringByValue(ReservedByte)), GetOwner());
+			UnreservedMovementModes.Add(CustomMovementModeInstance);
+			continue;
+		}
+
+		if (CustomMovementModeInstancesByByte.Num() <= ReservedByte)
+			CustomMovementModeInstancesByByte.SetNumZeroed(ReservedByte + 1);
+
+		CustomMovementModeInstancesByByte[ReservedByte] = CustomMovementModeInstance;
+		CustomMovementModeInstance->SetCustomMovementModeByte(ReservedByte);
+	}
+
+	// The rest get bytes past the enum range, so they never alias a reserved value of a mode that isn't added
+	int32 NextFreeByte = CustomMovementModeEnum->ContainsExistingMax()
+		                     ? CustomMovementModeEnum->GetMaxEnumValue()
+		                     : CustomMovementModeEnum->GetMaxEnumValue() + 1;
+	NextFreeByte = FMath::Max(NextFreeByte, CustomMovementModeInstancesByByte.Num());
+	for (UMMovementMode_Base* CustomMovementModeInstance : UnreservedMovementModes)
+	{
+		if (NextFreeByte > MAX_uint8)
+		{
+			M::Debug::LogUserError(LogMMovement, FString::Printf(
+				                       TEXT("Out of custom movement mode bytes, movement mode %s will never start"),
+				                       *CustomMovementModeInstance->GetMovementModeName().ToString()), GetOwner());
+			continue;
+		}
+
+		CustomMovementModeInstancesByByte.SetNumZeroed(NextFreeByte + 1);
+		CustomMovementModeInstancesByByte[NextFreeByte] = CustomMovementModeInstance;
+		CustomMovementModeInstance->SetCustomMovementModeByte(NextFreeByte);
+		++NextFreeByte;
+	}
+}
+
+void UMCharacterMovementComponent::BuildMovementModeTransitionMatrix()
+{
+	const int32 NumMovementModes = CustomMovementModeInstances.Num();
+	MovementModeInterruptMasks.Init(0, NumMovementModes);
+	MovementModeCooldownLinkMasks.Init(0, NumMovementModes);
+
+	for (int32 Slot = 0; Slot < NumMovementModes; ++Slot)
+	{
+		const UMMovementMode_Base* CustomMovementModeInstance = CustomMovementModeInstances[Slot];
+		const FMMovementModeTransitionConfig& TransitionConfig = CustomMovementModeInstance->GetTransitionConfig();
+
+		uint64 CannotInterruptMask = 0;
+		for (const TSubclassOf<UMMovementMode_Base>& MovementModeClass : TransitionConfig.CannotInterrupt)
+		{
+			CannotInterruptMask |= GetMovementModeMask(MovementModeClass);
+		}
+
+		uint64 LowerPriorityMask = 0;
+		for (int32 OtherSlot = 0; OtherSlot < NumMovementModes; ++OtherSlot)
+		{
+			if (CustomMovementModeInstances[OtherSlot]->GetTransitionConfig().InterruptPriority <= TransitionConfig.InterruptPriority)
+				LowerPriorityMask |= 1ull << OtherSlot;
+		}
+
+		MovementModeInterruptMasks[Slot] = LowerPriorityMask & ~CannotInterruptMask;
+
+		for (const TSubclassOf<UMMovementMode_Base>& MovementModeClass : TransitionConfig.ActivateCooldownOnEnd)
+		{
+			MovementModeCooldownLinkMasks[Slot] |= GetMovementModeMask(MovementModeClass);
+		}
+	}
+}
+
+uint64 UMCharacterMovementComponent::GetMovementModeMask(const TSubclassOf<UMMovementMode_Base> MovementModeClass) const
+{
+	if (MovementModeClass == nullptr)
+		return 0;
+
+	uint64 Mask = 0;
+	for (int32 Slot = 0; Slot < CustomMovementModeInstances.Num(); ++Slot)
+	{
+		if (CustomMovementModeInstances[Slot]->IsA(MovementModeClass))
+			Mask |= 1ull << Slot;
+	}
+
+	return Mask;
+}
+
+uint64 UMCharacterMovementComponent::GetActiveMovementModeMask() const
+{
+	const UMMovementMode_Base* ActiveCustomMovementMode = GetActiveCustomMovementModeInstance();
+	if (!IsValid(ActiveCustomMovementMode))
+		return 0;
+
+	return 1ull << ActiveCustomMovementMode->GetMovementModeSlot();
 }
 
 UPrimitiveComponent* UMCharacterMovementComponent::GetMovementBaseCustom() const
 {
 	UMMovementMode_Base* ActiveCustomMovementMode = GetActiveCustomMovementModeInstance();
-	if (IsValid(ActiveCustomMovementMode) && ActiveCustomMovementMode->IsUsingCustomMovementBase())
+	if (IsValid(ActiveCustomMovementMode) && ActiveCustomMovementMode->DispatchIsUsingCustomMovementBase())
 	{
 		return CustomMovementBase;
 	}
@@ -376,21 +827,21 @@ UMMovementMode_Base* UMCharacterMovementComponent::GetActiveCustomMovementModeIn
 
 void UMCharacterMovementComponent::SetWalkingSpeedType(UMCharacterMovementWalkingSpeedTypeAsset* SpeedTypeAsset)
 {
-	const bool bSettingsDefinedForAsset = SpeedConfigForSpeedTypeMap.Contains(SpeedTypeAsset);
-	if (!bSettingsDefinedForAsset)
+	const int32 SpeedTypeIndex = GetSpeedTypeIndex(SpeedTypeAsset);
+	if (SpeedTypeIndex == INDEX_NONE)
 	{
 		M::Debug::LogUserError(LogMMovement,
 		                       FString::Format(TEXT(
 			                       "Can't set walking speed type for type {0}, because config for this speed type are not defined in Movement Component"),
-		                                       {SpeedTypeAsset->GetName()}),
+		                                       {GetNameSafe(SpeedTypeAsset)}),
 		                       GetOwner());
 		return;
 	}
 
 	SpeedTypeCurrent = SpeedTypeAsset;
+	ResolveCurrentSpeedConfig();
 
-	const FMCharacterMovementWalkingSpeedConfig& SpeedConfig = SpeedConfigForSpeedTypeMap[SpeedTypeAsset];
-	ApplyWalkingSpeedConfig(SpeedConfig);
+	ApplyWalkingSpeedConfig(SpeedConfigResolved);
 }
 
 UMCharacterMovementWalkingSpeedTypeAsset* UMCharacterMovementComponent::GetCurrentWalkingSpeedType() const
@@ -400,25 +851,13 @@ UMCharacterMovementWalkingSpeedTypeAsset* UMCharacterMovementComponent::GetCurre
 
 FMCharacterMovementWalkingSpeedConfig UMCharacterMovementComponent::GetCurrentWalkingSpeedConfig() const
 {
-	if (SpeedTypeCurrent == nullptr)
+	if (SpeedTypeCurrent == nullptr && !bSpeedConfigErrorReported)
 	{
 		M::Debug::LogUserError(LogMMovement, TEXT("Can't get walking speed config, because walking speed type is not defined"), GetOwner());
-
-		return {};
-	}
-
-	const bool bSettingsDefinedForAsset = SpeedConfigForSpeedTypeMap.Contains(SpeedTypeCurrent);
-	if (!bSettingsDefinedForAsset)
-	{
-		M::Debug::LogUserError(LogMMovement,
-		                       FString::Format(TEXT(
-			                       "Can't get walking speed config for type {0}, because config for this speed type are not defined in Movement Component"),
-		                                       {SpeedTypeCurrent->GetName()}),
-		                       GetOwner());
-		return {};
+		bSpeedConfigErrorReported = true;
 	}
 
-	return SpeedConfigForSpeedTypeMap[SpeedTypeCurrent];
+	return SpeedConfigResolved;
 }
 
 FMCharacterMovementWalkingSpeedConfig UMCharacterMovementComponent::GetWalkingSpeedConfigForSpeedType(
@@ -432,8 +871,8 @@ FMCharacterMovementWalkingSpeedConfig UMCharacterMovementComponent::GetWalkingSp
 		return {};
 	}
 
-	const bool bSettingsDefinedForAsset = SpeedConfigForSpeedTypeMap.Contains(SpeedTypeAsset);
-	if (!bSettingsDefinedForAsset)
+	const int32 SpeedTypeIndex = GetSpeedTypeIndex(SpeedTypeAsset);
+	if (SpeedTypeIndex == INDEX_NONE)
 	{
 		M::Debug::LogUserError(LogMMovement,
 		                       FString::Format(TEXT(
@@ -443,13 +882,32 @@ FMCharacterMovementWalkingSpeedConfig UMCharacterMovementComponent::GetWalkingSp
 		return {};
 	}
 	
-	return SpeedConfigForSpeedTypeMap[SpeedTypeAsset];
+	return SpeedConfigTable[SpeedTypeIndex];
 }
 
 void UMCharacterMovementComponent::SetWalkingSpeedConfig(UMCharacterMovementWalkingSpeedTypeAsset* SpeedTypeAsset,
 	const FMCharacterMovementWalkingSpeedConfig& Config)
 {
 	SpeedConfigForSpeedTypeMap.Emplace(SpeedTypeAsset, Config);
+
+	if (SpeedTypeAsset == nullptr)
+		return;
+
+	const int32 SpeedTypeIndex = GetSpeedTypeIndex(SpeedTypeAsset);
+	if (SpeedTypeIndex == INDEX_NONE)
+	{
+		SpeedTypeTable.Emplace(SpeedTypeAsset);
+		SpeedConfigTable.Emplace(Config);
+	}
+	else
+	{
+		SpeedConfigTable[SpeedTypeIndex] = Config;
+	}
+
+	if (SpeedTypeAsset == SpeedTypeCurrent)
+	{
+		ResolveCurrentSpeedConfig();
+	}
 }
 
 void UMCharacterMovementComponent::SetCustomMovementBase(UPrimitiveComponent* InCustomMovementBase)
@@ -492,15 +950,52 @@ void UMCharacterMovementComponent::DrawDebugCharacterCapsule(const FColor& Color
 
 void UMCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
 {
-	// Start custom movement mode
-	for (int i = 0; i < CustomMovementModeInstances.Num(); ++i)
+	// Conditions fired by the component for this update, conditions signaled by the modes themselves are pending on the modes
+	EMMovementModeWakeCondition FiredWakeConditions = EMMovementModeWakeCondition::Always;
+
+	const bool bFalling = IsFalling();
+	if (bFalling)
+		FiredWakeConditions |= EMMovementModeWakeCondition::Falling;
+
+	if (bFalling != bWasFallingLastMovementUpdate)
+		FiredWakeConditions |= EMMovementModeWakeCondition::FallingTransition;
+
+	bWasFallingLastMovementUpdate = bFalling;
+
+	// Anything that could start a mode wakes the component up first
+	if (bMovementSleeping)
 	{
-		auto CustomMovementModeInstance = CustomMovementModeInstances[i];
+		Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+		return;
+	}
+
+	const UMMovementMode_Base* ActiveCustomMovementMode = GetActiveCustomMovementModeInstance();
+	const uint64 ActiveMovementModeMask = IsValid(ActiveCustomMovementMode) ? 1ull << ActiveCustomMovementMode->GetMovementModeSlot() : 0;
+
+	// Start custom movement mode (in priority order, only for modes whose wake conditions fired)
+	for (int32 Slot = 0; Slot < CustomMovementModeInstances.Num(); ++Slot)
+	{
+		UMMovementMode_Base* CustomMovementModeInstance = CustomMovementModeInstances[Slot];
+
+		const int32 CustomMovementModeByte = CustomMovementModeInstance->GetCustomMovementModeByte();
+		if (CustomMovementModeByte == INDEX_NONE)
+			continue;
+
+		// Skipped before any of its logic runs, pending wake conditions are kept for when the active mode ends
+		if (ActiveMovementModeMask != 0 && (MovementModeInterruptMasks[Slot] & ActiveMovementModeMask) == 0)
+		{
+			CustomMovementModeInstance->SetCanStartFailReasonCache(FMMovementMode_FailReason(
+				EMMovementMode_FailReasonCode::MovementModeActive, ActiveCustomMovementMode->GetMovementModeName()));
+			continue;
+		}
+
+		if (!CustomMovementModeInstance->ConsumeActivationWake(FiredWakeConditions))
+			continue;
 
-		FString CanStartFailReason;
-		if (CustomMovementModeInstance->CanStart(CanStartFailReason))
+		FMMovementMode_FailReason CanStartFailReason;
+		if (CustomMovementModeInstance->DispatchCanStart(CanStartFailReason))
 		{
-			SetMovementMode(MOVE_Custom, i);
+			SetMovementMode(MOVE_Custom, static_cast<uint8>(CustomMovementModeByte));
 			break;
 		}
 
@@ -512,18 +1007,28 @@ void UMCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const F
 
 void UMCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
 {
+	InvalidateMovementStateCache();
+	WakeMovement();
+
 	// Run custom movement mode end
 	if (PreviousMovementMode == MOVE_Custom)
 	{
 		if (auto CustomMovementModeInstance = GetCustomMovementModeInstanceForEnum(PreviousCustomMode))
-			CustomMovementModeInstance->End();
+		{
+			CustomMovementModeInstance->DispatchEnd();
+
+			for (uint64 Mask = MovementModeCooldownLinkMasks[CustomMovementModeInstance->GetMovementModeSlot()]; Mask != 0; Mask &= Mask - 1)
+			{
+				CustomMovementModeInstances[FMath::CountTrailingZeros64(Mask)]->ActivateCooldown();
+			}
+		}
 	}
 
 	// Run custom movement mode start
 	if (MovementMode == MOVE_Custom)
 	{
 		if (auto CustomMovementModeInstance = GetCustomMovementModeInstanceForEnum(CustomMovementMode))
-			CustomMovementModeInstance->Start();
+			CustomMovementModeInstance->DispatchStart();
 	}
 
 	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
@@ -536,19 +1041,32 @@ void UMCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
 		UMMovementMode_Base* ActiveCustomMovementModeInstance = GetActiveCustomMovementModeInstance();
 		if (IsValid(ActiveCustomMovementModeInstance))
 		{
-			ActiveCustomMovementModeInstance->Phys(deltaTime, Iterations);
+			ActiveCustomMovementModeInstance->DispatchPhys(deltaTime, Iterations);
 		}
 	}
 
 	Super::PhysCustom(deltaTime, Iterations);
 }
 
+void UMCharacterMovementComponent::StartNewPhysics(float deltaTime, int32 Iterations)
+{
+	InvalidateMovementStateCache();
+
+	Super::StartNewPhysics(deltaTime, Iterations);
+}
+
 bool UMCharacterMovementComponent::CanCrouchInCurrentState() const
+{
+	return GetCachedMovementState(EMMovementStateCacheFlags::CanCrouchResolved, EMMovementStateCacheFlags::CanCrouch,
+	                              &UMCharacterMovementComponent::ResolveCanCrouchInCurrentState);
+}
+
+bool UMCharacterMovementComponent::ResolveCanCrouchInCurrentState() const
 {
 	UMMovementMode_Base* ActiveCustomMovementMode = GetActiveCustomMovementModeInstance();
 	if (IsValid(ActiveCustomMovementMode))
 	{
-		return ActiveCustomMovementMode->CanCrouch();
+		return ActiveCustomMovementMode->DispatchCanCrouch();
 	}
 
 	return Super::CanCrouchInCurrentState();
@@ -575,22 +1093,35 @@ FVector UMCharacterMovementComponent::ScaleInputAcceleration(const FVector& Inpu
 	return Result;
 }
 
-void UMCharacterMovementComponent::UpdateTemporalHorizontalVelocityEntry()
+void UMCharacterMovementComponent::InitializeSignalHistories()
 {
-	TemporalHorizontalVelocityArray.Emplace(GetHorizontalVelocity());
-	if (TemporalHorizontalVelocityArray.Num() > TemporalPeakHorizontalVelocityHistoryFramesAmount)
-		TemporalHorizontalVelocityArray.RemoveAt(0);
+	// Extra sample, so the window is covered fully at max sample rate
+	const int32 Capacity = FMath::CeilToInt32(SignalHistoryDuration * SignalHistoryMaxSampleRate) + 1;
+	for (FMMovementSignalHistory& SignalHistory : SignalHistories)
+	{
+		SignalHistory.Initialize(Capacity, SignalHistoryDuration);
+	}
+}
+
+void UMCharacterMovementComponent::UpdateSignalHistories()
+{
+	const double Time = GetWorld()->GetTimeSeconds();
+
+	const FVector HorizontalVelocity = GetHorizontalVelocity();
+	SignalHistories[static_cast<uint8>(EMMovementSignal::HorizontalSpeed)].Push(Time, HorizontalVelocity.Size2D(), HorizontalVelocity);
+	SignalHistories[static_cast<uint8>(EMMovementSignal::VerticalSpeed)].Push(Time, Velocity.Z, Velocity);
+	SignalHistories[static_cast<uint8>(EMMovementSignal::Acceleration)].Push(Time, Acceleration.Size(), Acceleration);
 }
 
 UMMovementMode_Base* UMCharacterMovementComponent::GetCustomMovementModeInstanceForEnum(uint8 EnumValue) const
 {
-	if (!CustomMovementModeInstances.IsValidIndex(EnumValue))
+	if (!CustomMovementModeInstancesByByte.IsValidIndex(EnumValue) || CustomMovementModeInstancesByByte[EnumValue] == nullptr)
 	{
-		UE_LOG(LogTemp, Error, TEXT("Trying to get Custom Movement Mode for value out of CustomMovementModeInstances range"));
+		UE_LOG(LogMMovement, Error, TEXT("Trying to get Custom Movement Mode for value %d that no movement mode is assigned to"), EnumValue);
 		return nullptr;
 	}
 
-	return CustomMovementModeInstances[EnumValue];
+	return CustomMovementModeInstancesByByte[EnumValue];
 }
 
 FRotator UMCharacterMovementComponent::ComputeCharacterOrientation(const FRotator& CurrentRotation,
@@ -600,6 +1131,40 @@ FRotator UMCharacterMovementComponent::ComputeCharacterOrientation(const FRotato
 	return Super::ComputeOrientToMovementRotation(CurrentRotation, DeltaTime, DeltaRotation);
 }
 
+void UMCharacterMovementComponent::BuildSpeedConfigTable()
+{
+	SpeedTypeTable.Reset(SpeedConfigForSpeedTypeMap.Num());
+	SpeedConfigTable.Reset(SpeedConfigForSpeedTypeMap.Num());
+
+	for (const auto& SpeedConfigForSpeedTypePair : SpeedConfigForSpeedTypeMap)
+	{
+		if (SpeedConfigForSpeedTypePair.Key == nullptr)
+		{
+			M::Debug::LogUserError(LogMMovement, TEXT("SpeedConfigForSpeedTypeMap contains config for null speed type"), GetOwner());
+			continue;
+		}
+
+		SpeedTypeTable.Emplace(SpeedConfigForSpeedTypePair.Key);
+		SpeedConfigTable.Emplace(SpeedConfigForSpeedTypePair.Value);
+	}
+
+	ResolveCurrentSpeedConfig();
+}
+
+int32 UMCharacterMovementComponent::GetSpeedTypeIndex(const UMCharacterMovementWalkingSpeedTypeAsset* SpeedTypeAsset) const
+{
+	if (SpeedTypeAsset == nullptr)
+		return INDEX_NONE;
+
+	return SpeedTypeTable.IndexOfByKey(SpeedTypeAsset);
+}
+
+void UMCharacterMovementComponent::ResolveCurrentSpeedConfig()
+{
+	const int32 SpeedTypeIndex = GetSpeedTypeIndex(SpeedTypeCurrent);
+	SpeedConfigResolved = SpeedConfigTable.IsValidIndex(SpeedTypeIndex) ? SpeedConfigTable[SpeedTypeIndex] : FMCharacterMovementWalkingSpeedConfig();
+}
+
 void UMCharacterMovementComponent::ApplyWalkingSpeedConfig(const FMCharacterMovementWalkingSpeedConfig& Config)
 {
 	MaxWalkSpeed = Config.Speed;
@@ -2,3 +2,55 @@
 
 
 #include "MControlledLaunchAsset.h"
+
+#include "MMovementTypes.h"
+#include "Curves/CurveFloat.h"
+
+bool FMControlledLaunchParams::BakeCurves()
+{
+	AccelerationMultiplierCurveBaked.Bake(AccelerationMultiplierCurve);
+	BrakingDecelerationMultiplierCurveBaked.Bake(BrakingDecelerationMultiplierCurve);
+	GravityMultiplierCurveBaked.Bake(GravityMultiplierCurve);
+
+	bCurvesValid = !(bInfluenceInputAcceleration && AccelerationMultiplierCurve == nullptr)
+		&& !(bInfluenceBreakingDeceleration && BrakingDecelerationMultiplierCurve == nullptr)
+		&& !(bInfluenceGravity && GravityMultiplierCurve == nullptr);
+	bCurvesBaked = true;
+
+	return bCurvesValid;
+}
+
+void UMControlledLaunchAsset::PostLoad()
+{
+	Super::PostLoad();
+
+	BakeLaunchParams();
+}
+
+#if WITH_EDITOR
+void UMControlledLaunchAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BakeLaunchParams();
+}
+#endif
+
+void UMControlledLaunchAsset::BakeLaunchParams()
+{
+	// Curves have to be loaded before sampling
+	for (UCurveFloat* Curve : {
+		     LaunchParams.AccelerationMultiplierCurve.Get(),
+		     LaunchParams.BrakingDecelerationMultiplierCurve.Get(),
+		     LaunchParams.GravityMultiplierCurve.Get()
+	     })
+	{
+		if (Curve != nullptr)
+			Curve->ConditionalPostLoad();
+	}
+
+	if (!LaunchParams.BakeCurves())
+	{
+		UE_LOG(LogMMovement, Error, TEXT("Controlled Launch Asset %s has influenced values with null curves"), *GetName());
+	}
+}
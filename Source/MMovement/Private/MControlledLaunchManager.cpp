@@ -8,10 +8,10 @@
 
 void FMControlledLaunchManager_LaunchInstance::ProcessAndCombine(FMControlledLaunchManager_ProcessResult& ProcessResult) const
 {
+	const FMControlledLaunchParams& LaunchParams = GetLaunchParams();
 	if (LaunchParams.bInfluenceInputAcceleration)
 	{
-		const float AccelerationMultiplier = FMath::Clamp(
-			LaunchParams.AccelerationMultiplierCurve->GetFloatValue(DurationTimer.GetProgressNormalized()), 0, 1);
+		const float AccelerationMultiplier = GetAccelerationMultiplier();
 		ProcessResult.AccelerationMultiplier *= AccelerationMultiplier;
 
 		if (LaunchParams.bAllowFullInputAccelerationPerpendicularToLaunchDirection)
@@ -37,17 +37,51 @@ void FMControlledLaunchManager_LaunchInstance::ProcessAndCombine(FMControlledLau
 		}
 	}
 
-	if (LaunchParams.bInfluenceBreakingDeceleration)
-	{
-		ProcessResult.BrakingDecelerationMultiplier *= LaunchParams.BrakingDecelerationMultiplierCurve->GetFloatValue(
-			DurationTimer.GetProgressNormalized());
-	}
+	ProcessResult.BrakingDecelerationMultiplier *= GetBrakingDecelerationMultiplier();
+	ProcessResult.GravityMultiplier *= GetGravityMultiplier();
+}
 
-	if (LaunchParams.bInfluenceGravity)
-	{
-		ProcessResult.GravityMultiplier *= FMath::Clamp(
-			LaunchParams.GravityMultiplierCurve->GetFloatValue(DurationTimer.GetProgressNormalized()), 0, 1);
-	}
+float FMControlledLaunchManager_LaunchInstance::GetAccelerationMultiplier() const
+{
+	const FMControlledLaunchParams& LaunchParams = GetLaunchParams();
+	if (!LaunchParams.bInfluenceInputAcceleration)
+		return 1;
+
+	return FMath::Clamp(LaunchParams.AccelerationMultiplierCurveBaked.Evaluate(DurationTimer.GetProgressNormalized()), 0, 1);
+}
+
+float FMControlledLaunchManager_LaunchInstance::GetBrakingDecelerationMultiplier() const
+{
+	const FMControlledLaunchParams& LaunchParams = GetLaunchParams();
+	if (!LaunchParams.bInfluenceBreakingDeceleration)
+		return 1;
+
+	return LaunchParams.BrakingDecelerationMultiplierCurveBaked.Evaluate(DurationTimer.GetProgressNormalized());
+}
+
+float FMControlledLaunchManager_LaunchInstance::GetGravityMultiplier() const
+{
+	const FMControlledLaunchParams& LaunchParams = GetLaunchParams();
+	if (!LaunchParams.bInfluenceGravity)
+		return 1;
+
+	return FMath::Clamp(LaunchParams.GravityMultiplierCurveBaked.Evaluate(DurationTimer.GetProgressNormalized()), 0, 1);
+}
+
+FMControlledLaunchManager_InstanceMultipliers FMControlledLaunchManager_LaunchInstance::EvaluateMultipliers() const
+{
+	FMControlledLaunchManager_InstanceMultipliers Multipliers;
+	Multipliers.Acceleration = GetAccelerationMultiplier();
+	Multipliers.BrakingDeceleration = GetBrakingDecelerationMultiplier();
+	Multipliers.Gravity = GetGravityMultiplier();
+
+	return Multipliers;
+}
+
+void FMControlledLaunchManager_LaunchInstance::TickTimers(const float DeltaTime)
+{
+	DurationTimer.Tick(DeltaTime);
+	WalkingBlockTimer.Tick(DeltaTime);
 }
 
 #if ENABLE_VISUAL_LOG
@@ -111,7 +145,7 @@ void UMControlledLaunchManager::GrabDebugSnapshot(FVisualLogEntry* Snapshot) con
 
 bool UMControlledLaunchManager::IsAnyControlledLaunchActive() const
 {
-	return LaunchInstanceForOwner.Num() > 0 || LaunchInstancesWithoutOwner.Num() > 0;
+	return LaunchInstances.Num() > 0;
 }
 
 bool UMControlledLaunchManager::IsWalkBlockedByControlledLaunch() const
@@ -139,109 +173,183 @@ void UMControlledLaunchManager::Initialize(UMCharacterMovementComponent* InOwner
 
 void UMControlledLaunchManager::TickLaunches(float DeltaTime)
 {
-	TArray<UObject*> OwnersToRemove;
-	for (auto& Element : LaunchInstanceForOwner)
-	{
-		if (ShouldRemoveLaunchInstance(Element.Value))
-		{
-			OwnersToRemove.Emplace(Element.Key);
-			continue;
-		}
-
-		TickLaunchInstance(Element.Value, DeltaTime);
-	}
+	PruneLaunches();
 
-	for (UObject* OwnerToRemove : OwnersToRemove)
+	for (FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstances)
 	{
-		LaunchInstanceForOwner.Remove(OwnerToRemove);
+		TickLaunchInstance(LaunchInstance, DeltaTime);
 	}
 
-	for (int i = LaunchInstancesWithoutOwner.Num() - 1; i >= 0; i--)
+	++LaunchStateGeneration;
+	UpdateProcessCache();
+
+	ShowDebugs();
+}
+
+void UMControlledLaunchManager::PruneLaunches()
+{
+	// Iterating backwards, so instance swapped in on removal was already checked
+	for (int i = LaunchInstances.Num() - 1; i >= 0; i--)
 	{
-		if (ShouldRemoveLaunchInstance(LaunchInstancesWithoutOwner[i]))
+		if (ShouldRemoveLaunchInstance(LaunchInstances[i]))
 		{
-			LaunchInstancesWithoutOwner.RemoveAt(i);
-			continue;
+			RemoveLaunchInstanceAt(i);
 		}
-
-		TickLaunchInstance(LaunchInstancesWithoutOwner[i], DeltaTime);
 	}
+}
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+void UMControlledLaunchManager::ApplyBatchedMultipliers(
+	const TConstArrayView<FMControlledLaunchManager_InstanceMultipliers> InstanceMultipliers)
+{
+	check(InstanceMultipliers.Num() == LaunchInstances.Num());
+
+	++LaunchStateGeneration;
+
+	ResetProcessCache();
+	for (int i = 0; i < LaunchInstances.Num(); i++)
 	{
-		for (auto& Element : LaunchInstanceForOwner)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Orange,
-			                                 FString::Printf(
-				                                 TEXT("Controlled Launch (%s): %0.1f"), *Element.Key->GetName(),
-				                                 Element.Value.DurationTimer.GetTimeLeft()));
-		}
+		CombineIntoProcessCache(LaunchInstances[i], InstanceMultipliers[i]);
+	}
+}
 
-		for (const FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstancesWithoutOwner)
+void UMControlledLaunchManager::ShowDebugs() const
+{
+	if (ShouldShowMovementDebugs())
+	{
+		for (const FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstances)
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Orange,
-			                                 FString::Printf(
-				                                 TEXT("Controlled Launch: %0.1f"), LaunchInstance.DurationTimer.GetTimeLeft()));
+			if (LaunchInstance.OwnerKey != TObjectKey<UObject>())
+			{
+				GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Orange,
+				                                 FString::Printf(
+					                                 TEXT("Controlled Launch (%s): %0.1f"), *GetNameSafe(LaunchInstance.OwnerKey.ResolveObjectPtr()),
+					                                 LaunchInstance.DurationTimer.GetTimeLeft()));
+			}
+			else
+			{
+				GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Orange,
+				                                 FString::Printf(
+					                                 TEXT("Controlled Launch: %0.1f"), LaunchInstance.DurationTimer.GetTimeLeft()));
+			}
 		}
 	}
 }
 
-void UMControlledLaunchManager::AddControlledLaunch(const FVector& LaunchVelocity, const FMControlledLaunchParams& LaunchParams,
-                                                    UObject* Owner)
+FMControlledLaunchHandle UMControlledLaunchManager::AddControlledLaunch(const FVector& LaunchVelocity,
+                                                                        const FMControlledLaunchParams& LaunchParams, UObject* Owner)
 {
-	if ((LaunchParams.bInfluenceInputAcceleration && LaunchParams.AccelerationMultiplierCurve == nullptr)
-		|| (LaunchParams.bInfluenceBreakingDeceleration && LaunchParams.BrakingDecelerationMultiplierCurve == nullptr)
-		|| (LaunchParams.bInfluenceGravity && LaunchParams.GravityMultiplierCurve == nullptr))
-	{
-		UE_LOG(LogMMovement, Error, TEXT("Controlled Launch cannot be added, because some of the curves in Launch Parameters are null"));
-		return;
-	}
+	// Params from assets are baked on load, params created at runtime are baked here
+	TSharedRef<FMControlledLaunchParams> LaunchParamsBaked = MakeShared<FMControlledLaunchParams>(LaunchParams);
+	if (!LaunchParamsBaked->bCurvesBaked)
+		LaunchParamsBaked->BakeCurves();
 
-	if (LaunchVelocity.IsNearlyZero())
+	if (!LaunchParamsBaked->bCurvesValid)
 	{
-		UE_LOG(LogMMovement, Error, TEXT("Controlled Launch cannot be added, because Launch Velocity is 0 or nearly 0"));
-		return;
+		UE_LOG(LogMMovement, Error, TEXT("Controlled Launch cannot be added, because some of the curves in Launch Parameters are null"));
+		return FMControlledLaunchHandle();
 	}
 
-	OwnerMovementComponent->Launch(LaunchVelocity);
+	FMControlledLaunchManager_LaunchInstance LaunchInstance = FMControlledLaunchManager_LaunchInstance(*LaunchParamsBaked, LaunchVelocity);
+	LaunchInstance.InlineLaunchParams = LaunchParamsBaked;
 
-	FMControlledLaunchManager_LaunchInstance LaunchInstance = FMControlledLaunchManager_LaunchInstance(LaunchParams, LaunchVelocity);
+	return AddLaunchInstance(MoveTemp(LaunchInstance), Owner);
+}
 
-	if (Owner != nullptr)
+FMControlledLaunchHandle UMControlledLaunchManager::AddControlledLaunchFromAsset(const FVector& LaunchVelocity,
+                                                                                 const UMControlledLaunchAsset* LaunchAsset,
+                                                                                 UObject* Owner)
+{
+	if (LaunchAsset == nullptr)
 	{
-		if (LaunchInstanceForOwner.Contains(Owner))
-			LaunchInstanceForOwner[Owner] = LaunchInstance;
-		else
-			LaunchInstanceForOwner.Add(Owner, LaunchInstance);
+		UE_LOG(LogMMovement, Error, TEXT("Controlled Launch cannot be added, because Launch Asset is null"));
+		return FMControlledLaunchHandle();
 	}
-	else
+
+	// Asset created at runtime wasn't baked on load, launch gets its own baked copy of params
+	if (!LaunchAsset->LaunchParams.bCurvesBaked)
+		return AddControlledLaunch(LaunchVelocity, LaunchAsset->LaunchParams, Owner);
+
+	if (!LaunchAsset->LaunchParams.bCurvesValid)
 	{
-		LaunchInstancesWithoutOwner.Emplace(LaunchInstance);
+		UE_LOG(LogMMovement, Error, TEXT("Controlled Launch cannot be added, because some of the curves in Launch Asset %s are null"),
+		       *LaunchAsset->GetName());
+		return FMControlledLaunchHandle();
 	}
+
+	FMControlledLaunchManager_LaunchInstance LaunchInstance = FMControlledLaunchManager_LaunchInstance(
+		LaunchAsset->LaunchParams, LaunchVelocity);
+	LaunchInstance.LaunchAsset = LaunchAsset;
+
+	return AddLaunchInstance(MoveTemp(LaunchInstance), Owner);
+}
+
+const FMControlledLaunchManager_LaunchInstance* UMControlledLaunchManager::FindLaunchInstance(const FMControlledLaunchHandle Handle) const
+{
+	const int32 InstanceIndex = GetInstanceIndex(Handle);
+	return InstanceIndex != INDEX_NONE ? &LaunchInstances[InstanceIndex] : nullptr;
+}
+
+bool UMControlledLaunchManager::CancelControlledLaunch(const FMControlledLaunchHandle Handle)
+{
+	const int32 InstanceIndex = GetInstanceIndex(Handle);
+	if (InstanceIndex == INDEX_NONE)
+		return false;
+
+	RemoveLaunchInstanceAt(InstanceIndex);
+	return true;
+}
+
+bool UMControlledLaunchManager::IsControlledLaunchActive(const FMControlledLaunchHandle Handle) const
+{
+	return GetInstanceIndex(Handle) != INDEX_NONE;
 }
 
 void UMControlledLaunchManager::ClearAllLaunches()
 {
-	LaunchInstanceForOwner.Empty();
-	LaunchInstancesWithoutOwner.Empty();
+	// Invalidate handles of all active launches
+	for (const FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstances)
+	{
+		FMControlledLaunchManager_Slot& Slot = Slots[LaunchInstance.SlotIndex];
+		Slot.InstanceIndex = INDEX_NONE;
+		++Slot.Generation;
+
+		FreeSlotIndices.Emplace(LaunchInstance.SlotIndex);
+	}
+
+	LaunchInstances.Reset();
+	SlotIndexForOwner.Reset();
+
+	++LaunchStateGeneration;
 }
 
 FMControlledLaunchManager_ProcessResult UMControlledLaunchManager::Process(const FVector& AccelerationCurrent) const
 {
+	const FMControlledLaunchManager_ProcessCache& Cache = GetProcessCache();
+
 	FMControlledLaunchManager_ProcessResult ProcessResult = FMControlledLaunchManager_ProcessResult(AccelerationCurrent);
+	ProcessResult.AccelerationMultiplier = Cache.AccelerationMultiplier;
+	ProcessResult.BrakingDecelerationMultiplier = Cache.BrakingDecelerationMultiplier;
+	ProcessResult.GravityMultiplier = Cache.GravityMultiplier;
 
-	ForEachActiveLaunchInstanceConst([&ProcessResult](const FMControlledLaunchManager_LaunchInstance& LaunchInstance)
+	// Uniform scaling commutes with projections (all operations are linear), so it can be applied at once
+	FVector Acceleration = AccelerationCurrent * Cache.UniformAccelerationMultiplier;
+	for (const FMControlledLaunchManager_AccelerationProjection& Projection : Cache.AccelerationProjections)
 	{
-		LaunchInstance.ProcessAndCombine(ProcessResult);
-		return true;
-	});
+		// Get acceleration perpendicular to horizontal launch direction
+		const FVector AccelerationPerp = FVector::VectorPlaneProject(Acceleration, Projection.LaunchDirectionHorizontal);
+
+		// Scale only acceleration in launch direction
+		Acceleration = AccelerationPerp + (Acceleration - AccelerationPerp) * Projection.Multiplier;
+	}
+
+	ProcessResult.Acceleration = Acceleration;
 
 	return ProcessResult;
 }
 
 void UMControlledLaunchManager::ForEachActiveLaunchInstance(const TFunctionRef<bool(FMControlledLaunchManager_LaunchInstance&)>& Func)
 {
-	for (auto& [Owner, LaunchInstance] : LaunchInstanceForOwner)
+	for (FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstances)
 	{
 		const bool bContinue = Func(LaunchInstance);
 		if (!bContinue)
@@ -249,8 +357,12 @@ void UMControlledLaunchManager::ForEachActiveLaunchInstance(const TFunctionRef<b
 			return;
 		}
 	}
+}
 
-	for (FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstancesWithoutOwner)
+void UMControlledLaunchManager::ForEachActiveLaunchInstanceConst(
+	const TFunctionRef<bool(const FMControlledLaunchManager_LaunchInstance&)>& Func) const
+{
+	for (const FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstances)
 	{
 		const bool bContinue = Func(LaunchInstance);
 		if (!bContinue)
@@ -260,32 +372,136 @@ void UMControlledLaunchManager::ForEachActiveLaunchInstance(const TFunctionRef<b
 	}
 }
 
-void UMControlledLaunchManager::ForEachActiveLaunchInstanceConst(
-	const TFunctionRef<bool(const FMControlledLaunchManager_LaunchInstance&)>& Func) const
+void UMControlledLaunchManager::TickLaunchInstance(FMControlledLaunchManager_LaunchInstance& LaunchInstance, float DeltaTime)
 {
-	for (const auto& [Owner, LaunchInstance] : LaunchInstanceForOwner)
+	LaunchInstance.TickTimers(DeltaTime);
+}
+
+FMControlledLaunchHandle UMControlledLaunchManager::AddLaunchInstance(FMControlledLaunchManager_LaunchInstance&& LaunchInstance,
+                                                                      UObject* Owner)
+{
+	if (LaunchInstance.LaunchVelocity.IsNearlyZero())
 	{
-		const bool bContinue = Func(LaunchInstance);
-		if (!bContinue)
-		{
-			return;
-		}
+		UE_LOG(LogMMovement, Error, TEXT("Controlled Launch cannot be added, because Launch Velocity is 0 or nearly 0"));
+		return FMControlledLaunchHandle();
 	}
 
-	for (const FMControlledLaunchManager_LaunchInstance& LaunchInstance : LaunchInstancesWithoutOwner)
+	OwnerMovementComponent->Launch(LaunchInstance.LaunchVelocity);
+
+	// Replace launch of the same owner
+	if (Owner != nullptr)
 	{
-		const bool bContinue = Func(LaunchInstance);
-		if (!bContinue)
+		LaunchInstance.OwnerKey = Owner;
+
+		if (const int32* OwnerSlotIndex = SlotIndexForOwner.Find(LaunchInstance.OwnerKey))
 		{
-			return;
+			RemoveLaunchInstanceAt(Slots[*OwnerSlotIndex].InstanceIndex);
 		}
 	}
+
+	const int32 SlotIndex = FreeSlotIndices.Num() > 0 ? FreeSlotIndices.Pop() : Slots.AddDefaulted();
+	FMControlledLaunchManager_Slot& Slot = Slots[SlotIndex];
+
+	LaunchInstance.SlotIndex = SlotIndex;
+	Slot.InstanceIndex = LaunchInstances.Emplace(MoveTemp(LaunchInstance));
+
+	if (Owner != nullptr)
+	{
+		SlotIndexForOwner.Add(Owner, SlotIndex);
+	}
+
+	++LaunchStateGeneration;
+
+	return FMControlledLaunchHandle(SlotIndex, Slot.Generation);
 }
 
-void UMControlledLaunchManager::TickLaunchInstance(FMControlledLaunchManager_LaunchInstance& LaunchInstance, float DeltaTime)
+int32 UMControlledLaunchManager::GetInstanceIndex(const FMControlledLaunchHandle Handle) const
 {
-	LaunchInstance.DurationTimer.Tick(DeltaTime);
-	LaunchInstance.WalkingBlockTimer.Tick(DeltaTime);
+	if (!Slots.IsValidIndex(Handle.SlotIndex))
+		return INDEX_NONE;
+
+	const FMControlledLaunchManager_Slot& Slot = Slots[Handle.SlotIndex];
+	return Slot.Generation == Handle.Generation ? Slot.InstanceIndex : INDEX_NONE;
+}
+
+void UMControlledLaunchManager::RemoveLaunchInstanceAt(const int32 InstanceIndex)
+{
+	const FMControlledLaunchManager_LaunchInstance& LaunchInstance = LaunchInstances[InstanceIndex];
+	if (LaunchInstance.OwnerKey != TObjectKey<UObject>())
+	{
+		SlotIndexForOwner.Remove(LaunchInstance.OwnerKey);
+	}
+
+	FMControlledLaunchManager_Slot& Slot = Slots[LaunchInstance.SlotIndex];
+	Slot.InstanceIndex = INDEX_NONE;
+	++Slot.Generation;
+	FreeSlotIndices.Emplace(LaunchInstance.SlotIndex);
+
+	LaunchInstances.RemoveAtSwap(InstanceIndex);
+
+	// Point slot of the moved instance to its new index
+	if (LaunchInstances.IsValidIndex(InstanceIndex))
+	{
+		Slots[LaunchInstances[InstanceIndex].SlotIndex].InstanceIndex = InstanceIndex;
+	}
+
+	++LaunchStateGeneration;
+}
+
+const FMControlledLaunchManager_ProcessCache& UMControlledLaunchManager::GetProcessCache() const
+{
+	if (ProcessCache.Generation != LaunchStateGeneration)
+	{
+		UpdateProcessCache();
+	}
+
+	return ProcessCache;
+}
+
+void UMControlledLaunchManager::UpdateProcessCache() const
+{
+	ResetProcessCache();
+
+	ForEachActiveLaunchInstanceConst([this](const FMControlledLaunchManager_LaunchInstance& LaunchInstance)
+	{
+		CombineIntoProcessCache(LaunchInstance, LaunchInstance.EvaluateMultipliers());
+		return true;
+	});
+}
+
+void UMControlledLaunchManager::ResetProcessCache() const
+{
+	ProcessCache.Generation = LaunchStateGeneration;
+	ProcessCache.AccelerationMultiplier = 1;
+	ProcessCache.BrakingDecelerationMultiplier = 1;
+	ProcessCache.GravityMultiplier = 1;
+	ProcessCache.UniformAccelerationMultiplier = 1;
+	ProcessCache.AccelerationProjections.Reset();
+}
+
+void UMControlledLaunchManager::CombineIntoProcessCache(const FMControlledLaunchManager_LaunchInstance& LaunchInstance,
+                                                        const FMControlledLaunchManager_InstanceMultipliers& InstanceMultipliers) const
+{
+	const FMControlledLaunchParams& LaunchParams = LaunchInstance.GetLaunchParams();
+	if (LaunchParams.bInfluenceInputAcceleration)
+	{
+		ProcessCache.AccelerationMultiplier *= InstanceMultipliers.Acceleration;
+
+		if (LaunchParams.bAllowFullInputAccelerationPerpendicularToLaunchDirection)
+		{
+			FMControlledLaunchManager_AccelerationProjection& Projection = ProcessCache.AccelerationProjections.AddDefaulted_GetRef();
+			Projection.LaunchDirectionHorizontal = FVector(LaunchInstance.LaunchVelocity.X, LaunchInstance.LaunchVelocity.Y, 0).
+				GetSafeNormal();
+			Projection.Multiplier = InstanceMultipliers.Acceleration;
+		}
+		else
+		{
+			ProcessCache.UniformAccelerationMultiplier *= InstanceMultipliers.Acceleration;
+		}
+	}
+
+	ProcessCache.BrakingDecelerationMultiplier *= InstanceMultipliers.BrakingDeceleration;
+	ProcessCache.GravityMultiplier *= InstanceMultipliers.Gravity;
 }
 
 bool UMControlledLaunchManager::ShouldRemoveLaunchInstance(const FMControlledLaunchManager_LaunchInstance& LaunchInstance) const
@@ -298,7 +514,7 @@ bool UMControlledLaunchManager::ShouldRemoveLaunchInstance(const FMControlledLau
 		return true;
 	}
 
-	if (LaunchInstance.LaunchParams.bDisableOnSpeedInHorizontalLaunchDirectionBelowThreshold)
+	if (LaunchInstance.GetLaunchParams().bDisableOnSpeedInHorizontalLaunchDirectionBelowThreshold)
 	{
 		FVector VelocityHorizontal = OwnerMovementComponent->Velocity;
 		VelocityHorizontal.Z = 0;
@@ -315,7 +531,7 @@ bool UMControlledLaunchManager::ShouldRemoveLaunchInstance(const FMControlledLau
 		}
 	}
 
-	if (LaunchInstance.LaunchParams.bDisableOnSurface
+	if (LaunchInstance.GetLaunchParams().bDisableOnSurface
 		&& LaunchInstance.DurationTimer.GetTimeElapsed() > 0.5f
 		&& OwnerMovementComponent->IsMovingOnSurface())
 	{
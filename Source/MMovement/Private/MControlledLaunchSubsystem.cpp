@@ -0,0 +1,166 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MControlledLaunchSubsystem.h"
+
+#include "MCharacterMovementComponent.h"
+#include "MMovementTypes.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Controlled Launch Subsystem Tick"), STAT_MMovement_ControlledLaunchSubsystemTick, STATGROUP_MMovement);
+
+void FMControlledLaunchSubsystemTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+                                                          const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (IsValid(Subsystem) && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Subsystem->TickManagers(DeltaTime);
+	}
+}
+
+FString FMControlledLaunchSubsystemTickFunction::DiagnosticMessage()
+{
+	return TEXT("UMControlledLaunchSubsystem::TickManagers");
+}
+
+FName FMControlledLaunchSubsystemTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return TEXT("MControlledLaunchSubsystem");
+}
+
+void UMControlledLaunchSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	TickFunction.Subsystem = this;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = false;
+	TickFunction.bRunOnAnyThread = false;
+	TickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+
+	UpdateTickEnabled();
+}
+
+void UMControlledLaunchSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	for (UMCharacterMovementComponent* MovementComponent : MovementComponents)
+	{
+		if (IsValid(MovementComponent) && IsValid(MovementComponent->GetControlledLaunchManager()))
+		{
+			MovementComponent->GetControlledLaunchManager()->SetTickedBySubsystem(false);
+		}
+	}
+
+	MovementComponents.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMControlledLaunchSubsystem::RegisterMovementComponent(UMCharacterMovementComponent* MovementComponent)
+{
+	if (!IsValid(MovementComponent) || !IsValid(MovementComponent->GetControlledLaunchManager()))
+		return;
+
+	if (MovementComponents.Contains(MovementComponent))
+		return;
+
+	MovementComponents.Emplace(MovementComponent);
+	MovementComponent->GetControlledLaunchManager()->SetTickedBySubsystem(true);
+	MovementComponent->PrimaryComponentTick.AddPrerequisite(this, TickFunction);
+
+	UpdateTickEnabled();
+}
+
+void UMControlledLaunchSubsystem::UnregisterMovementComponent(UMCharacterMovementComponent* MovementComponent)
+{
+	if (MovementComponents.RemoveSwap(MovementComponent) == 0)
+		return;
+
+	if (IsValid(MovementComponent->GetControlledLaunchManager()))
+	{
+		MovementComponent->GetControlledLaunchManager()->SetTickedBySubsystem(false);
+	}
+
+	MovementComponent->PrimaryComponentTick.RemovePrerequisite(this, TickFunction);
+
+	UpdateTickEnabled();
+}
+
+void UMControlledLaunchSubsystem::TickManagers(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_ControlledLaunchSubsystemTick);
+
+	BatchInstances.Reset();
+	BatchDeltaTimes.Reset();
+	BatchManagers.Reset();
+	ManagerBatchOffsets.Reset();
+
+	// Prune and gather on game thread, removal depends on owner movement state
+	for (UMCharacterMovementComponent* MovementComponent : MovementComponents)
+	{
+		if (!IsValid(MovementComponent))
+			continue;
+
+		UMControlledLaunchManager* ControlledLaunchManager = MovementComponent->GetControlledLaunchManager();
+		if (!IsValid(ControlledLaunchManager))
+			continue;
+
+		ControlledLaunchManager->PruneLaunches();
+
+		// Respect time dilation of the owner, same as component tick would
+		const AActor* Owner = MovementComponent->GetOwner();
+		const float ManagerDeltaTime = IsValid(Owner) ? DeltaTime * Owner->CustomTimeDilation : DeltaTime;
+
+		BatchManagers.Emplace(ControlledLaunchManager);
+		ManagerBatchOffsets.Emplace(BatchInstances.Num());
+
+		ControlledLaunchManager->ForEachActiveLaunchInstance(
+			[this, ManagerDeltaTime](FMControlledLaunchManager_LaunchInstance& LaunchInstance)
+			{
+				BatchInstances.Emplace(&LaunchInstance);
+				BatchDeltaTimes.Emplace(ManagerDeltaTime);
+				return true;
+			});
+	}
+
+	ManagerBatchOffsets.Emplace(BatchInstances.Num());
+
+	// Timers and curve sampling are pure math on separate instances
+	BatchMultipliers.SetNumUninitialized(BatchInstances.Num());
+	ParallelFor(BatchInstances.Num(), [this](const int32 Index)
+	{
+		FMControlledLaunchManager_LaunchInstance& LaunchInstance = *BatchInstances[Index];
+		LaunchInstance.TickTimers(BatchDeltaTimes[Index]);
+		BatchMultipliers[Index] = LaunchInstance.EvaluateMultipliers();
+	});
+
+	// Publish results to managers
+	for (int i = 0; i < BatchManagers.Num(); i++)
+	{
+		const int32 BatchOffset = ManagerBatchOffsets[i];
+		const int32 InstanceCount = ManagerBatchOffsets[i + 1] - BatchOffset;
+		BatchManagers[i]->ApplyBatchedMultipliers(TConstArrayView<FMControlledLaunchManager_InstanceMultipliers>(
+			BatchMultipliers.GetData() + BatchOffset, InstanceCount));
+
+		BatchManagers[i]->ShowDebugs();
+	}
+}
+
+bool UMControlledLaunchSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMControlledLaunchSubsystem::UpdateTickEnabled()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.SetTickFunctionEnable(MovementComponents.Num() > 0);
+	}
+}
@@ -0,0 +1,29 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MMovementDiagnostics.h"
+
+FString FMMovementSurfaceValidationRecord::ToString() const
+{
+	const TCHAR* AngleRangeStr = bActiveAngleRange ? TEXT(" (active)") : TEXT("");
+
+	switch (Result)
+	{
+	case EMMovementSurfaceValidationResult::Valid:
+		return TEXT("Valid");
+	case EMMovementSurfaceValidationResult::ComponentAlreadyValidated:
+		return TEXT("Skipped - Component already validated");
+	case EMMovementSurfaceValidationResult::MissingRequiredCategory:
+		return FString::Printf(TEXT("Invalid - Surface doesn't have required tag (tag required: %s)"), *Category.ToString());
+	case EMMovementSurfaceValidationResult::ExcludedCategory:
+		return FString::Printf(TEXT("Invalid - Surface contains exclusion tag (exclusion tag: %s)"), *Category.ToString());
+	case EMMovementSurfaceValidationResult::AssistQueryMissed:
+		return TEXT("Invalid - Assist query did not hit the surface");
+	case EMMovementSurfaceValidationResult::SurfaceAngleTooLow:
+		return FString::Printf(TEXT("Invalid - Surface angle too low%s (angle: %.2f, min: %.2f)"), AngleRangeStr, Value, Limit);
+	case EMMovementSurfaceValidationResult::SurfaceAngleTooHigh:
+		return FString::Printf(TEXT("Invalid - Surface angle too high%s (angle: %.2f, max: %.2f)"), AngleRangeStr, Value, Limit);
+	}
+
+	return FString();
+}
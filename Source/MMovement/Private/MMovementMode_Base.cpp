@@ -4,7 +4,12 @@
 #include "MMovementMode_Base.h"
 
 #include "MCharacterMovementComponent.h"
+#include "MDebug.h"
+#include "MMovementMode_OrientToMovementInterface.h"
+#include "MMovementSurfaceSubsystem.h"
 #include "MMovementTypes.h"
+#include "MTraversalFieldSubsystem.h"
+#include "MTraversalIndexSubsystem.h"
 #include "GameFramework/Character.h"
 
 #if ENABLE_VISUAL_LOG
@@ -22,7 +27,7 @@ void UMMovementMode_Base::GrabDebugSnapshot(struct FVisualLogEntry* Snapshot) co
 	else
 	{
 		StateLog = FString::Printf(
-			TEXT("Inactive: %s"), *GetCanStartFailReasonCache());
+			TEXT("Inactive: %s"), *GetCanStartFailReasonCache().ToString());
 	}
 
 	MovementModeCategory.Add(TEXT("State"), StateLog);
@@ -44,11 +49,14 @@ void UMMovementMode_Base::Initialize(ACharacter* InCharacterOwner, UMCharacterMo
 	MovementComponent = InMovementComponent;
 	CharacterOwner = InCharacterOwner;
 	UpdatedComponent = MovementComponent->UpdatedComponent;
+	SurfaceSubsystem = MovementComponent->GetWorld()->GetSubsystem<UMMovementSurfaceSubsystem>();
+	TraversalIndexSubsystem = MovementComponent->GetWorld()->GetSubsystem<UMTraversalIndexSubsystem>();
+	TraversalFieldSubsystem = MovementComponent->GetWorld()->GetSubsystem<UMTraversalFieldSubsystem>();
 
 	Initialize();
 }
 
-bool UMMovementMode_Base::CanStart_Implementation(FString& OutFailReason)
+bool UMMovementMode_Base::CanStart_Implementation(FMMovementMode_FailReason& OutFailReason)
 {
 	return true;
 }
@@ -81,11 +89,225 @@ FName UMMovementMode_Base::GetMovementModeName() const
 	return MovementModeName;
 }
 
+void UMMovementMode_Base::BuildDispatchTable()
+{
+	const UClass* Class = GetClass();
+
+	DispatchTable = FMMovementMode_DispatchTable();
+	DispatchTable.ScriptEvents = EMMovementModeEvent::None;
+
+	auto RegisterScriptEvent = [this, Class](const EMMovementModeEvent Event, const FName FunctionName)
+	{
+		if (Class->IsFunctionImplementedInScript(FunctionName))
+			DispatchTable.ScriptEvents |= Event;
+	};
+
+	RegisterScriptEvent(EMMovementModeEvent::Tick, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, Tick));
+	RegisterScriptEvent(EMMovementModeEvent::CanStart, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, CanStart));
+	RegisterScriptEvent(EMMovementModeEvent::Start, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, Start));
+	RegisterScriptEvent(EMMovementModeEvent::Phys, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, Phys));
+	RegisterScriptEvent(EMMovementModeEvent::End, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, End));
+	RegisterScriptEvent(EMMovementModeEvent::CanCrouch, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, CanCrouch));
+	RegisterScriptEvent(EMMovementModeEvent::IsMovingOnGround, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, IsMovingOnGround));
+	RegisterScriptEvent(EMMovementModeEvent::IsMovingOnSurface, GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, IsMovingOnSurface));
+	RegisterScriptEvent(EMMovementModeEvent::IsUsingCustomMovementBase,
+	                    GET_FUNCTION_NAME_CHECKED(UMMovementMode_Base, IsUsingCustomMovementBase));
+
+	DispatchTable.bImplementsOrientToMovementInterface = Class->ImplementsInterface(UMMovementMode_OrientToMovementInterface::StaticClass());
+	if (DispatchTable.bImplementsOrientToMovementInterface)
+	{
+		DispatchTable.OrientToMovementInterfaceNative = Cast<IMMovementMode_OrientToMovementInterface>(this);
+
+		// Interface added in Blueprint has no native implementation to call
+		if (DispatchTable.OrientToMovementInterfaceNative == nullptr)
+		{
+			DispatchTable.ScriptEvents |= EMMovementModeEvent::ComputeOrientToMovementRotation;
+		}
+		else
+		{
+			RegisterScriptEvent(EMMovementModeEvent::ComputeOrientToMovementRotation,
+			                    GET_FUNCTION_NAME_CHECKED(IMMovementMode_OrientToMovementInterface, ComputeOrientToMovementRotation));
+		}
+	}
+}
+
+void UMMovementMode_Base::DispatchTick(const float DeltaTime)
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::Tick))
+	{
+		Tick(DeltaTime);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	Tick_Implementation(DeltaTime);
+}
+
+bool UMMovementMode_Base::DispatchCanStart(FMMovementMode_FailReason& OutFailReason)
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::CanStart))
+		return CanStart(OutFailReason);
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	return CanStart_Implementation(OutFailReason);
+}
+
+void UMMovementMode_Base::DispatchStart()
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::Start))
+	{
+		Start();
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	Start_Implementation();
+}
+
+void UMMovementMode_Base::DispatchPhys(const float DeltaTime, const int32 Iterations)
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::Phys))
+	{
+		Phys(DeltaTime, Iterations);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	Phys_Implementation(DeltaTime, Iterations);
+}
+
+void UMMovementMode_Base::DispatchEnd()
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::End))
+	{
+		End();
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	End_Implementation();
+}
+
+bool UMMovementMode_Base::DispatchCanCrouch()
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::CanCrouch))
+		return CanCrouch();
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	return CanCrouch_Implementation();
+}
+
+bool UMMovementMode_Base::DispatchIsMovingOnGround()
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::IsMovingOnGround))
+		return IsMovingOnGround();
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	return IsMovingOnGround_Implementation();
+}
+
+bool UMMovementMode_Base::DispatchIsMovingOnSurface()
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::IsMovingOnSurface))
+		return IsMovingOnSurface();
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	return IsMovingOnSurface_Implementation();
+}
+
+bool UMMovementMode_Base::DispatchIsUsingCustomMovementBase()
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::IsUsingCustomMovementBase))
+		return IsUsingCustomMovementBase();
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	return IsUsingCustomMovementBase_Implementation();
+}
+
+FRotator UMMovementMode_Base::DispatchComputeOrientToMovementRotation(const FRotator& CurrentRotation, const float DeltaTime,
+                                                                      FRotator& DeltaRotation)
+{
+	if (DispatchTable.IsScriptEvent(EMMovementModeEvent::ComputeOrientToMovementRotation))
+	{
+		return IMMovementMode_OrientToMovementInterface::Execute_ComputeOrientToMovementRotation(
+			this, CurrentRotation, DeltaTime, DeltaRotation);
+	}
+
+	INC_DWORD_STAT(STAT_MMovement_ScriptCallsAvoided);
+	return DispatchTable.OrientToMovementInterfaceNative->ComputeOrientToMovementRotation_Implementation(
+		CurrentRotation, DeltaTime, DeltaRotation);
+}
+
+void UMMovementMode_Base::WakeActivationCheck(const EMMovementModeWakeCondition Condition)
+{
+	PendingWakeConditions |= Condition;
+
+	// Sleeping component doesn't evaluate CanStart
+	if (IsValid(MovementComponent))
+		MovementComponent->WakeMovement();
+}
+
+bool UMMovementMode_Base::AllowsMovementSleep() const
+{
+	// Script Tick and CanStart polled on every update can't be skipped
+	return !DispatchTable.IsScriptEvent(EMMovementModeEvent::Tick)
+		&& !EnumHasAnyFlags(static_cast<EMMovementModeWakeCondition>(WakeConditions), EMMovementModeWakeCondition::Always);
+}
+
+bool UMMovementMode_Base::ConsumeActivationWake(const EMMovementModeWakeCondition FiredConditions)
+{
+	const EMMovementModeWakeCondition ModeWakeConditions = static_cast<EMMovementModeWakeCondition>(WakeConditions);
+	const bool bWake = EnumHasAnyFlags(FiredConditions | PendingWakeConditions, ModeWakeConditions);
+
+	PendingWakeConditions = EMMovementModeWakeCondition::None;
+
+	return bWake;
+}
+
 FVector UMMovementMode_Base::GetOwnerLocation() const
 {
 	return CharacterOwner->GetActorLocation();
 }
 
+void UMMovementMode_Base::TickTimerWithActivationWake(FMManualTimer& Timer, const float DeltaTime)
+{
+	const bool bCompletedBeforeTick = Timer.IsCompleted();
+	Timer.Tick(DeltaTime);
+
+	if (!bCompletedBeforeTick && Timer.IsCompleted())
+		WakeActivationCheck(EMMovementModeWakeCondition::TimerExpired);
+}
+
+void UMMovementMode_Base::RegisterTraversalIndexSurfaceFilter(const FMMovementSurfaceFilter& SurfaceFilter)
+{
+	// Index exists only in game worlds
+	if (!IsValid(TraversalIndexSubsystem))
+		return;
+
+	if (!TraversalIndexSubsystem->RegisterSurfaceFilter(SurfaceFilter))
+	{
+		M::Debug::LogUserError(LogMMovement, FString::Printf(
+			                       TEXT("%s can't use traversal index without a required surface tag, physics queries will be used instead"),
+			                       *GetMovementModeName().ToString()), CharacterOwner);
+	}
+}
+
+EMMovementSurfaceFilterResult UMMovementMode_Base::ClassifySurface(const FMMovementSurfaceFilter& SurfaceFilter,
+                                                                  const UPrimitiveComponent* PrimitiveComponent,
+                                                                  FName* OutExcludedCategory) const
+{
+	// Subsystem doesn't exist in preview and inactive worlds
+	if (!IsValid(SurfaceSubsystem))
+		return SurfaceFilter.ClassifyByTags(PrimitiveComponent, OutExcludedCategory);
+
+	const uint64 SurfaceCategoryMask = SurfaceSubsystem->GetSurfaceCategoryMask(PrimitiveComponent);
+	const EMMovementSurfaceFilterResult Result = SurfaceFilter.Classify(SurfaceCategoryMask);
+	if (Result == EMMovementSurfaceFilterResult::ExcludedCategory && OutExcludedCategory != nullptr)
+		*OutExcludedCategory = SurfaceSubsystem->GetFirstCategoryName(SurfaceCategoryMask & SurfaceFilter.ExcludedMask);
+
+	return Result;
+}
+
 #if ENABLE_VISUAL_LOG
 void UMMovementMode_Base::AddVisualLoggerInfo(struct FVisualLogEntry* Snapshot, FVisualLogStatusCategory& MovementCmpCategory,
                                               FVisualLogStatusCategory& MovementModeCategory) const
@@ -112,7 +334,7 @@ void UMMovementMode_Base::Start_Implementation()
 
 	OnMovementModeStartDelegate.Broadcast();
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		MovementComponent->DrawDebugCharacterCapsule(FColor::Green, 5, GetMovementModeName().ToString());
 		GEngine->AddOnScreenDebugMessage(-1, 1, FColor::Green, FString::Printf(TEXT("%s: started"), *GetMovementModeName().ToString()));
@@ -125,7 +347,7 @@ void UMMovementMode_Base::End_Implementation()
 
 	OnMovementModeEndDelegate.Broadcast();
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		MovementComponent->DrawDebugCharacterCapsule(FColor::Red, 5, GetMovementModeName().ToString());
 		GEngine->AddOnScreenDebugMessage(-1, 1, FColor::Red, FString::Printf(TEXT("%s: ended"), *GetMovementModeName().ToString()));
@@ -0,0 +1,55 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MMovementQueryConfig.h"
+
+#include "Engine/World.h"
+
+bool FMMovementQueryConfig::SweepMulti(const UWorld* World, TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End,
+                                       const FQuat& Rotation, const FCollisionShape& CollisionShape,
+                                       const FCollisionQueryParams& QueryParams) const
+{
+	switch (QueryType)
+	{
+	case EMMovementQueryType::Profile:
+		return World->SweepMultiByProfile(OutHits, Start, End, Rotation, CollisionProfile.Name, CollisionShape, QueryParams);
+	case EMMovementQueryType::ObjectTypes:
+		return World->SweepMultiByObjectType(OutHits, Start, End, Rotation, MakeObjectQueryParams(), CollisionShape, QueryParams);
+	case EMMovementQueryType::Channel:
+	default:
+		return World->SweepMultiByChannel(OutHits, Start, End, Rotation, TraceChannel, CollisionShape, QueryParams);
+	}
+}
+
+bool FMMovementQueryConfig::LineTraceSingle(const UWorld* World, FHitResult& OutHit, const FVector& Start, const FVector& End,
+                                            const FCollisionQueryParams& QueryParams) const
+{
+	switch (QueryType)
+	{
+	case EMMovementQueryType::Profile:
+		return World->LineTraceSingleByProfile(OutHit, Start, End, CollisionProfile.Name, QueryParams);
+	case EMMovementQueryType::ObjectTypes:
+		return World->LineTraceSingleByObjectType(OutHit, Start, End, MakeObjectQueryParams(), QueryParams);
+	case EMMovementQueryType::Channel:
+	default:
+		return World->LineTraceSingleByChannel(OutHit, Start, End, TraceChannel, QueryParams);
+	}
+}
+
+FTraceHandle FMMovementQueryConfig::AsyncSweepMulti(UWorld* World, const FVector& Start, const FVector& End, const FQuat& Rotation,
+                                                    const FCollisionShape& CollisionShape,
+                                                    const FCollisionQueryParams& QueryParams) const
+{
+	switch (QueryType)
+	{
+	case EMMovementQueryType::Profile:
+		return World->AsyncSweepByProfile(EAsyncTraceType::Multi, Start, End, Rotation, CollisionProfile.Name, CollisionShape,
+		                                  QueryParams);
+	case EMMovementQueryType::ObjectTypes:
+		return World->AsyncSweepByObjectType(EAsyncTraceType::Multi, Start, End, Rotation, MakeObjectQueryParams(), CollisionShape,
+		                                     QueryParams);
+	case EMMovementQueryType::Channel:
+	default:
+		return World->AsyncSweepByChannel(EAsyncTraceType::Multi, Start, End, Rotation, TraceChannel, CollisionShape, QueryParams);
+	}
+}
@@ -0,0 +1,87 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MMovementSurfaceSensor.h"
+
+#include "MMovementTypes.h"
+
+DECLARE_CYCLE_STAT(TEXT("Surface Sensing Sync"), STAT_MMovement_SurfaceSensingSync, STATGROUP_MMovement);
+DECLARE_CYCLE_STAT(TEXT("Surface Sensing Async Request"), STAT_MMovement_SurfaceSensingAsyncRequest, STATGROUP_MMovement);
+DECLARE_CYCLE_STAT(TEXT("Surface Sensing Async Consume"), STAT_MMovement_SurfaceSensingAsyncConsume, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Surface Sensing Async Fallbacks"), STAT_MMovement_SurfaceSensingAsyncFallbacks, STATGROUP_MMovement);
+DEFINE_STAT(STAT_MMovement_SurfaceAssistQueries);
+DEFINE_STAT(STAT_MMovement_SurfaceAssistQueriesSkipped);
+
+void FMMovementSurfaceSensor::SweepSync(const UWorld* World, const FVector& Start, const FVector& End, const FMMovementQueryConfig& QueryConfig,
+                                        const FCollisionShape& CollisionShape, const FCollisionQueryParams& QueryParams,
+                                        TArray<FHitResult>& OutHits)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_SurfaceSensingSync);
+
+	QueryConfig.SweepMulti(World, OutHits, Start, End, FQuat::Identity, CollisionShape, QueryParams);
+}
+
+void FMMovementSurfaceSensor::RequestAsyncSweep(UWorld* World, const FVector& PredictedStart, const FVector& PredictedEnd,
+                                                const FMMovementQueryConfig& QueryConfig, const FCollisionShape& CollisionShape,
+                                                const FCollisionQueryParams& QueryParams)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_SurfaceSensingAsyncRequest);
+
+	FRequest& Request = PendingRequests[RequestIndex];
+	Request.Handle = QueryConfig.AsyncSweepMulti(World, PredictedStart, PredictedEnd, FQuat::Identity, CollisionShape, QueryParams);
+	Request.PredictedStart = PredictedStart;
+
+	RequestIndex ^= 1;
+}
+
+bool FMMovementSurfaceSensor::ConsumeAsyncSweep(UWorld* World, const FVector& ActualStart, const float MaxPredictionError,
+                                                TArray<FHitResult>& OutHits)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_SurfaceSensingAsyncConsume);
+
+	// Request from the previous frame, slot is free for the next request afterward
+	FRequest& Request = PendingRequests[RequestIndex ^ 1];
+	if (!Request.Handle.IsValid())
+		return false;
+
+	const FTraceHandle Handle = Request.Handle;
+	Request.Handle = FTraceHandle();
+
+	const FVector PredictionError = ActualStart - Request.PredictedStart;
+	if (PredictionError.SizeSquared() > FMath::Square(MaxPredictionError))
+	{
+		INC_DWORD_STAT(STAT_MMovement_SurfaceSensingAsyncFallbacks);
+		return false;
+	}
+
+	FTraceDatum TraceDatum;
+	if (!World->QueryTraceData(Handle, TraceDatum))
+	{
+		INC_DWORD_STAT(STAT_MMovement_SurfaceSensingAsyncFallbacks);
+		return false;
+	}
+
+	OutHits.Reset(TraceDatum.OutHits.Num());
+	for (FHitResult& Hit : TraceDatum.OutHits)
+	{
+		// Component could have been destroyed since the sweep was performed
+		if (!IsValid(Hit.GetComponent()))
+			continue;
+
+		// Impact stays on the hit surface, shape location only slides along its plane. Error is bounded by MaxPredictionError
+		Hit.TraceStart += PredictionError;
+		Hit.TraceEnd += PredictionError;
+		Hit.Location += FVector::VectorPlaneProject(PredictionError, Hit.ImpactNormal);
+
+		OutHits.Add(MoveTemp(Hit));
+	}
+
+	return true;
+}
+
+void FMMovementSurfaceSensor::Reset()
+{
+	PendingRequests[0] = FRequest();
+	PendingRequests[1] = FRequest();
+	RequestIndex = 0;
+}
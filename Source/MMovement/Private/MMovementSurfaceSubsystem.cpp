@@ -0,0 +1,177 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MMovementSurfaceSubsystem.h"
+
+#include "MMovementSurfaceUserData.h"
+#include "MMovementTypes.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+
+void FMMovementSurfaceFilter::Compile(UMMovementSurfaceSubsystem* SurfaceSubsystem, const FName InRequiredCategory,
+                                      const TConstArrayView<FName> InExcludedCategories)
+{
+	RequiredMask = 0;
+	ExcludedMask = 0;
+
+	RequiredCategory = InRequiredCategory;
+	ExcludedCategories = InExcludedCategories;
+
+	if (SurfaceSubsystem == nullptr)
+		return;
+
+	if (!RequiredCategory.IsNone())
+	{
+		const int32 CategoryBit = SurfaceSubsystem->RegisterCategory(RequiredCategory);
+		if (CategoryBit != INDEX_NONE)
+			RequiredMask |= 1ull << CategoryBit;
+	}
+
+	for (const FName& ExcludedCategory : ExcludedCategories)
+	{
+		const int32 CategoryBit = SurfaceSubsystem->RegisterCategory(ExcludedCategory);
+		if (CategoryBit != INDEX_NONE)
+			ExcludedMask |= 1ull << CategoryBit;
+	}
+}
+
+EMMovementSurfaceFilterResult FMMovementSurfaceFilter::ClassifyByTags(const UPrimitiveComponent* PrimitiveComponent,
+                                                                      FName* OutExcludedCategory) const
+{
+	if (!RequiredCategory.IsNone() && (PrimitiveComponent == nullptr || !PrimitiveComponent->ComponentHasTag(RequiredCategory)))
+		return EMMovementSurfaceFilterResult::MissingRequiredCategory;
+
+	if (PrimitiveComponent == nullptr)
+		return EMMovementSurfaceFilterResult::Passed;
+
+	for (const FName& ExcludedCategory : ExcludedCategories)
+	{
+		if (PrimitiveComponent->ComponentHasTag(ExcludedCategory))
+		{
+			if (OutExcludedCategory != nullptr)
+				*OutExcludedCategory = ExcludedCategory;
+
+			return EMMovementSurfaceFilterResult::ExcludedCategory;
+		}
+	}
+
+	return EMMovementSurfaceFilterResult::Passed;
+}
+
+int32 UMMovementSurfaceSubsystem::RegisterCategory(const FName Category)
+{
+	if (Category.IsNone())
+		return INDEX_NONE;
+
+	if (const int32* CategoryBit = CategoryBitMap.Find(Category))
+		return *CategoryBit;
+
+	if (Categories.Num() >= MaxCategoryCount)
+	{
+		UE_LOG(LogMMovement, Error, TEXT("Can't register movement surface category %s, all %d categories are taken"),
+		       *Category.ToString(), MaxCategoryCount);
+		return INDEX_NONE;
+	}
+
+	const int32 CategoryBit = Categories.Add(Category);
+	CategoryBitMap.Add(Category, CategoryBit);
+
+	// Cached masks don't include tags matching the new category
+	SurfaceCategoryMasks.Reset();
+
+	return CategoryBit;
+}
+
+FName UMMovementSurfaceSubsystem::GetCategoryName(const int32 CategoryBit) const
+{
+	return Categories.IsValidIndex(CategoryBit) ? Categories[CategoryBit] : NAME_None;
+}
+
+uint64 UMMovementSurfaceSubsystem::GetSurfaceCategoryMask(const UPrimitiveComponent* PrimitiveComponent)
+{
+	if (!IsValid(PrimitiveComponent))
+		return 0;
+
+	if (const uint64* CategoryMask = SurfaceCategoryMasks.Find(PrimitiveComponent))
+		return *CategoryMask;
+
+	const uint64 CategoryMask = ResolveSurfaceCategoryMask(PrimitiveComponent);
+
+	if (SurfaceCategoryMasks.Num() >= SurfaceCategoryMasksCompactThreshold)
+		RemoveStaleSurfaceCategoryMasks();
+
+	SurfaceCategoryMasks.Add(PrimitiveComponent, CategoryMask);
+
+	return CategoryMask;
+}
+
+void UMMovementSurfaceSubsystem::InvalidateSurfaceCategoryMask(const UPrimitiveComponent* PrimitiveComponent)
+{
+	SurfaceCategoryMasks.Remove(PrimitiveComponent);
+}
+
+FName UMMovementSurfaceSubsystem::GetFirstCategoryName(const uint64 CategoryMask) const
+{
+	if (CategoryMask == 0)
+		return NAME_None;
+
+	return GetCategoryName(static_cast<int32>(FMath::CountTrailingZeros64(CategoryMask)));
+}
+
+void UMMovementSurfaceSubsystem::GatherUserDataCategories(const UPrimitiveComponent* PrimitiveComponent, TArray<FName>& OutCategories)
+{
+	TArray<const UMMovementSurfaceUserData*, TInlineAllocator<2>> SurfaceUserDataArray;
+
+	UPrimitiveComponent* MutablePrimitiveComponent = const_cast<UPrimitiveComponent*>(PrimitiveComponent);
+	if (const UMMovementSurfaceUserData* ComponentUserData = MutablePrimitiveComponent->GetAssetUserData<UMMovementSurfaceUserData>())
+		SurfaceUserDataArray.Add(ComponentUserData);
+
+	if (const UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(PrimitiveComponent))
+	{
+		if (UStaticMesh* StaticMesh = StaticMeshComponent->GetStaticMesh())
+		{
+			if (const UMMovementSurfaceUserData* MeshUserData = StaticMesh->GetAssetUserData<UMMovementSurfaceUserData>())
+				SurfaceUserDataArray.Add(MeshUserData);
+		}
+	}
+
+	for (const UMMovementSurfaceUserData* SurfaceUserData : SurfaceUserDataArray)
+	{
+		OutCategories.Append(SurfaceUserData->SurfaceCategories);
+	}
+}
+
+uint64 UMMovementSurfaceSubsystem::ResolveSurfaceCategoryMask(const UPrimitiveComponent* PrimitiveComponent)
+{
+	TArray<FName> UserDataCategories;
+	GatherUserDataCategories(PrimitiveComponent, UserDataCategories);
+
+	uint64 CategoryMask = 0;
+	for (const FName& Category : UserDataCategories)
+	{
+		const int32 CategoryBit = RegisterCategory(Category);
+		if (CategoryBit != INDEX_NONE)
+			CategoryMask |= 1ull << CategoryBit;
+	}
+
+	// Migration path, tags are treated as categories if some filter or surface uses them
+	for (const FName& Tag : PrimitiveComponent->ComponentTags)
+	{
+		if (const int32* CategoryBit = CategoryBitMap.Find(Tag))
+			CategoryMask |= 1ull << *CategoryBit;
+	}
+
+	return CategoryMask;
+}
+
+void UMMovementSurfaceSubsystem::RemoveStaleSurfaceCategoryMasks()
+{
+	for (auto It = SurfaceCategoryMasks.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+			It.RemoveCurrent();
+	}
+
+	// Grow threshold if most entries are still alive, so compaction doesn't run on every new component
+	SurfaceCategoryMasksCompactThreshold = FMath::Max(SurfaceCategoryMasksCompactThreshold, SurfaceCategoryMasks.Num() * 2);
+}
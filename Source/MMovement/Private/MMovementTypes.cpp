@@ -4,4 +4,58 @@
 
 DEFINE_LOG_CATEGORY(LogMMovement);
 
+DEFINE_STAT(STAT_MMovement_ScriptCallsAvoided);
+
+FString FMMovementMode_FailReason::ToString() const
+{
+	switch (Code)
+	{
+	case EMMovementMode_FailReasonCode::None:
+		return FString();
+	case EMMovementMode_FailReasonCode::Custom:
+		return Context.ToString();
+	case EMMovementMode_FailReasonCode::NotFalling:
+		return TEXT("Character is not falling");
+	case EMMovementMode_FailReasonCode::MovementModeActive:
+		return FString::Printf(TEXT("%s is active"), *Context.ToString());
+	case EMMovementMode_FailReasonCode::Cooldown:
+		return TEXT("Cooldown");
+	case EMMovementMode_FailReasonCode::NotTriggeredByInput:
+		return TEXT("Not triggered by input");
+	case EMMovementMode_FailReasonCode::InputNotHeld:
+		return TEXT("Input not held");
+	case EMMovementMode_FailReasonCode::AwaitsInputUp:
+		return TEXT("Awaits input up");
+	case EMMovementMode_FailReasonCode::ChargesDepleted:
+		return TEXT("Charges depleted");
+	case EMMovementMode_FailReasonCode::SurfaceInvalid:
+		return TEXT("Surface is not valid");
+	case EMMovementMode_FailReasonCode::TooCloseToGround:
+		return TEXT("Too close to ground");
+	case EMMovementMode_FailReasonCode::HorizontalSpeedTooLow:
+		return FString::Printf(TEXT("Horizontal speed is too low (hspeed: %.2f, min: %.2f)"), Value, Limit);
+	case EMMovementMode_FailReasonCode::VerticalSpeedTooLow:
+		return FString::Printf(TEXT("Vertical speed is too low (vspeed: %.2f, min: %.2f)"), Value, Limit);
+	case EMMovementMode_FailReasonCode::SurfaceToForwardAngleTooLow:
+		return FString::Printf(TEXT("Angle between character forward and surface normal too low (angle: %.2f, min: %.2f)"),
+		                       Value, Limit);
+	case EMMovementMode_FailReasonCode::SurfaceToForwardAngleTooHigh:
+		return FString::Printf(TEXT("Angle between character forward and surface normal too high (angle: %.2f, max: %.2f)"),
+		                       Value, Limit);
+	case EMMovementMode_FailReasonCode::SurfaceToVelocityAngleTooHigh:
+		return FString::Printf(TEXT("Angle between surface normal and horizontal velocity too high (angle: %.2f, max: %.2f)"),
+		                       Value, Limit);
+	case EMMovementMode_FailReasonCode::SurfaceNormalAngleChangeTooHigh:
+		return FString::Printf(TEXT("Surface normal angle delta too high (angle: %.2f, max: %.2f)"), Value, Limit);
+	case EMMovementMode_FailReasonCode::CannotRunBackwards:
+		return TEXT("Can't wall run backwards, because it's not activated in config");
+	case EMMovementMode_FailReasonCode::SlideDirectionUndetermined:
+		return TEXT("Slide direction can't be determined from movement input");
+	case EMMovementMode_FailReasonCode::CannotStartFromFalling:
+		return TEXT("Can't start slide from falling");
+	}
+
+	return FString();
+}
+
 TAutoConsoleVariable<bool> CVarShowMovementDebugs(TEXT("m.Movement.ShowDebugs"), false, TEXT("Show Movement Debugs"));
\ No newline at end of file
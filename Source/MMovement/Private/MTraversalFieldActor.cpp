@@ -0,0 +1,69 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MTraversalFieldActor.h"
+
+#include "MTraversalFieldAsset.h"
+#include "MTraversalFieldSubsystem.h"
+
+AMTraversalFieldActor::AMTraversalFieldActor()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent->SetMobility(EComponentMobility::Static);
+
+	SetHidden(true);
+	SetCanBeDamaged(false);
+
+#if WITH_EDITORONLY_DATA
+	bIsSpatiallyLoaded = true;
+#endif
+}
+
+void AMTraversalFieldActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (FieldAsset == nullptr)
+		return;
+
+	if (UMTraversalFieldSubsystem* TraversalFieldSubsystem = GetWorld()->GetSubsystem<UMTraversalFieldSubsystem>())
+	{
+		TraversalFieldSubsystem->RegisterField(FieldAsset);
+	}
+}
+
+void AMTraversalFieldActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (FieldAsset != nullptr)
+	{
+		if (UMTraversalFieldSubsystem* TraversalFieldSubsystem = GetWorld()->GetSubsystem<UMTraversalFieldSubsystem>())
+		{
+			TraversalFieldSubsystem->UnregisterField(FieldAsset);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+#if WITH_EDITOR
+FBox AMTraversalFieldActor::GetStreamingBounds() const
+{
+	if (FieldAsset != nullptr && FieldAsset->GetBounds().IsValid)
+		return FieldAsset->GetBounds();
+
+	return Super::GetStreamingBounds();
+}
+
+void AMTraversalFieldActor::SetFieldAsset(UMTraversalFieldAsset* InFieldAsset)
+{
+	Modify();
+	FieldAsset = InFieldAsset;
+
+	if (FieldAsset != nullptr)
+	{
+		SetActorLocation(FieldAsset->GetBounds().GetCenter());
+	}
+}
+#endif
@@ -0,0 +1,207 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MTraversalFieldAsset.h"
+
+#include "EngineUtils.h"
+#include "MMovementTypes.h"
+#include "MMovementSurfaceSubsystem.h"
+#include "MTraversalIndexSubsystem.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/Crc.h"
+
+void UMTraversalFieldAsset::Serialize(FArchive& Ar)
+{
+	Super::Serialize(Ar);
+
+	Cells.BulkSerialize(Ar);
+}
+
+const FMTraversalFieldCell* UMTraversalFieldAsset::FindCell(const FIntVector& Cell) const
+{
+	const int32 Index = Algo::LowerBoundBy(Cells, Cell, &FMTraversalFieldCell::Cell, &FMTraversalFieldCell::IsCellLess);
+	if (Cells.IsValidIndex(Index) && Cells[Index].Cell == Cell)
+		return &Cells[Index];
+
+	return nullptr;
+}
+
+FIntVector UMTraversalFieldAsset::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize),
+	                  FMath::FloorToInt(Location.Y / CellSize),
+	                  FMath::FloorToInt(Location.Z / CellSize));
+}
+
+uint32 UMTraversalFieldAsset::ComputeContentHash() const
+{
+	uint32 Hash = FCrc::MemCrc32(&CellSize, sizeof(CellSize));
+	for (const FName& Category : Categories)
+	{
+		Hash = FCrc::StrCrc32(*Category.ToString(), Hash);
+	}
+
+	for (const FMTraversalFieldCell& FieldCell : Cells)
+	{
+		Hash = FCrc::MemCrc32(&FieldCell.Cell, sizeof(FieldCell.Cell), Hash);
+		Hash = FCrc::MemCrc32(&FieldCell.SurfacePoint, sizeof(FieldCell.SurfacePoint), Hash);
+		Hash = FCrc::MemCrc32(&FieldCell.SurfaceNormal, sizeof(FieldCell.SurfaceNormal), Hash);
+		Hash = FCrc::MemCrc32(&FieldCell.SnapDistance, sizeof(FieldCell.SnapDistance), Hash);
+		Hash = FCrc::MemCrc32(&FieldCell.CategoryMask, sizeof(FieldCell.CategoryMask), Hash);
+	}
+
+	return Hash;
+}
+
+#if WITH_EDITOR
+void UMTraversalFieldAsset::BakeWorld(const UWorld* World, const FMTraversalFieldBakeSettings& Settings,
+                                      TMap<FIntVector, TArray<FMTraversalFieldCell>>& OutRegionCells)
+{
+	OutRegionCells.Reset();
+
+	if (World == nullptr || Settings.Categories.IsEmpty() || Settings.CellSize <= 0 || Settings.RegionSize < Settings.CellSize)
+		return;
+
+	struct FBakeComponent
+	{
+		FString PathName;
+		const UPrimitiveComponent* PrimitiveComponent;
+		uint64 CategoryMask;
+	};
+
+	// Static components with baked categories, sorted by path name so the bake doesn't depend on load order
+	TArray<FBakeComponent> BakeComponents;
+	TArray<FName> ComponentCategories;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(*It);
+		for (const UPrimitiveComponent* PrimitiveComponent : PrimitiveComponents)
+		{
+			if (PrimitiveComponent->Mobility != EComponentMobility::Static || !PrimitiveComponent->IsCollisionEnabled())
+				continue;
+
+			ComponentCategories.Reset();
+			UMMovementSurfaceSubsystem::GatherUserDataCategories(PrimitiveComponent, ComponentCategories);
+			ComponentCategories.Append(PrimitiveComponent->ComponentTags);
+
+			uint64 CategoryMask = 0;
+			for (int32 CategoryIndex = 0; CategoryIndex < Settings.Categories.Num() && CategoryIndex < 64; ++CategoryIndex)
+			{
+				if (ComponentCategories.Contains(Settings.Categories[CategoryIndex]))
+				{
+					CategoryMask |= 1ull << CategoryIndex;
+				}
+			}
+
+			if (CategoryMask != 0)
+			{
+				BakeComponents.Add({PrimitiveComponent->GetPathName(), PrimitiveComponent, CategoryMask});
+			}
+		}
+	}
+
+	BakeComponents.Sort([](const FBakeComponent& A, const FBakeComponent& B) { return A.PathName < B.PathName; });
+
+	const float CellSize = Settings.CellSize;
+	const FVector Reach(Settings.MaxSnapDistance);
+
+	TMap<FIntVector, FMTraversalFieldCell> BakedCells;
+	TArray<FVector> TriangleVertices;
+	for (const FBakeComponent& BakeComponent : BakeComponents)
+	{
+		TriangleVertices.Reset();
+		if (!UMTraversalIndexSubsystem::GatherCollisionTriangles(BakeComponent.PrimitiveComponent, TriangleVertices))
+		{
+			UE_LOG(LogMMovement, Warning, TEXT("Traversal field bake: collision of %s can't be baked (only box and convex collision is supported)"),
+			       *BakeComponent.PathName);
+			continue;
+		}
+
+		for (int32 i = 0; i + 2 < TriangleVertices.Num(); i += 3)
+		{
+			const FVector& A = TriangleVertices[i];
+			const FVector& B = TriangleVertices[i + 1];
+			const FVector& C = TriangleVertices[i + 2];
+
+			const FVector Normal = FVector::CrossProduct(B - A, C - A).GetSafeNormal();
+			if (Normal.IsZero())
+				continue;
+
+			const FBox TriangleBounds = FBox(TArray<FVector>{A, B, C}).ExpandBy(Reach);
+			const FIntVector CellMin(FMath::FloorToInt(TriangleBounds.Min.X / CellSize), FMath::FloorToInt(TriangleBounds.Min.Y / CellSize),
+			                         FMath::FloorToInt(TriangleBounds.Min.Z / CellSize));
+			const FIntVector CellMax(FMath::FloorToInt(TriangleBounds.Max.X / CellSize), FMath::FloorToInt(TriangleBounds.Max.Y / CellSize),
+			                         FMath::FloorToInt(TriangleBounds.Max.Z / CellSize));
+
+			for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+			{
+				for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+				{
+					for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+					{
+						const FIntVector Cell(X, Y, Z);
+						const FVector CellCenter = (FVector(Cell) + 0.5f) * CellSize;
+						const FVector ClosestPoint = FMath::ClosestPointOnTriangleToPoint(CellCenter, A, B, C);
+						const float Distance = FVector::Dist(CellCenter, ClosestPoint);
+						if (Distance > Settings.MaxSnapDistance)
+							continue;
+
+						// Ties keep the earlier surface, which keeps the bake deterministic
+						FMTraversalFieldCell* ExistingCell = BakedCells.Find(Cell);
+						if (ExistingCell != nullptr && ExistingCell->SnapDistance <= Distance)
+							continue;
+
+						FMTraversalFieldCell& FieldCell = ExistingCell != nullptr ? *ExistingCell : BakedCells.Add(Cell);
+						FieldCell.Cell = Cell;
+						FieldCell.SurfacePoint = FVector3f(ClosestPoint);
+						FieldCell.SurfaceNormal = FVector3f(Normal);
+						FieldCell.SnapDistance = Distance;
+						FieldCell.CategoryMask = BakeComponent.CategoryMask;
+					}
+				}
+			}
+		}
+	}
+
+	const int32 CellsPerRegion = FMath::Max(FMath::FloorToInt(Settings.RegionSize / CellSize), 1);
+	for (const TPair<FIntVector, FMTraversalFieldCell>& BakedCell : BakedCells)
+	{
+		const FIntVector& Cell = BakedCell.Key;
+		const FIntVector Region(FMath::FloorToInt(static_cast<float>(Cell.X) / CellsPerRegion),
+		                        FMath::FloorToInt(static_cast<float>(Cell.Y) / CellsPerRegion),
+		                        FMath::FloorToInt(static_cast<float>(Cell.Z) / CellsPerRegion));
+		OutRegionCells.FindOrAdd(Region).Add(BakedCell.Value);
+	}
+
+	OutRegionCells.KeySort([](const FIntVector& A, const FIntVector& B) { return FMTraversalFieldCell::IsCellLess(A, B); });
+	for (TPair<FIntVector, TArray<FMTraversalFieldCell>>& RegionCells : OutRegionCells)
+	{
+		RegionCells.Value.Sort();
+	}
+}
+
+void UMTraversalFieldAsset::SetBakedData(const FBox& InBounds, const float InCellSize, const TArray<FName>& InCategories,
+                                         TArray<FMTraversalFieldCell>&& InCells)
+{
+	Bounds = InBounds;
+	CellSize = InCellSize;
+	Categories = InCategories;
+	Cells = MoveTemp(InCells);
+	Cells.Sort();
+}
+
+FString UMTraversalFieldAsset::ExportText() const
+{
+	FString Text;
+	for (const FMTraversalFieldCell& FieldCell : Cells)
+	{
+		Text += FString::Printf(TEXT("%d %d %d | %.2f %.2f %.2f | %.3f %.3f %.3f | %.2f | %llx\n"),
+		                        FieldCell.Cell.X, FieldCell.Cell.Y, FieldCell.Cell.Z,
+		                        FieldCell.SurfacePoint.X, FieldCell.SurfacePoint.Y, FieldCell.SurfacePoint.Z,
+		                        FieldCell.SurfaceNormal.X, FieldCell.SurfaceNormal.Y, FieldCell.SurfaceNormal.Z,
+		                        FieldCell.SnapDistance, FieldCell.CategoryMask);
+	}
+
+	return Text;
+}
+#endif
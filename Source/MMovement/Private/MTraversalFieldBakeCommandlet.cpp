@@ -0,0 +1,147 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MTraversalFieldBakeCommandlet.h"
+
+#include "EngineUtils.h"
+#include "MMovementTypes.h"
+#include "MTraversalFieldActor.h"
+#include "MTraversalFieldAsset.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_EDITOR
+#include "FileHelpers.h"
+#endif
+
+UMTraversalFieldBakeCommandlet::UMTraversalFieldBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMTraversalFieldBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogMMovement, Error, TEXT("Traversal field bake: -Map= is required"));
+		return 1;
+	}
+
+	FMTraversalFieldBakeSettings Settings;
+
+	FString CategoriesParam;
+	if (FParse::Value(*Params, TEXT("Categories="), CategoriesParam, false))
+	{
+		TArray<FString> CategoryNames;
+		CategoriesParam.ParseIntoArray(CategoryNames, TEXT(","));
+		for (const FString& CategoryName : CategoryNames)
+		{
+			Settings.Categories.AddUnique(FName(CategoryName.TrimStartAndEnd()));
+		}
+	}
+	else
+	{
+		Settings.Categories.Add(WallRunnableTagName);
+	}
+
+	FParse::Value(*Params, TEXT("CellSize="), Settings.CellSize);
+	FParse::Value(*Params, TEXT("Reach="), Settings.MaxSnapDistance);
+	FParse::Value(*Params, TEXT("RegionSize="), Settings.RegionSize);
+	const bool bDump = FParse::Param(*Params, TEXT("Dump"));
+
+	if (Settings.Categories.Num() > 64)
+	{
+		UE_LOG(LogMMovement, Error, TEXT("Traversal field bake: at most 64 categories can be baked"));
+		return 1;
+	}
+
+	UWorld* World = UEditorLoadingAndSavingUtils::LoadMap(MapName);
+	if (World == nullptr)
+	{
+		UE_LOG(LogMMovement, Error, TEXT("Traversal field bake: failed to load map %s"), *MapName);
+		return 1;
+	}
+
+	TMap<FIntVector, TArray<FMTraversalFieldCell>> RegionCells;
+	UMTraversalFieldAsset::BakeWorld(World, Settings, RegionCells);
+
+	// Existing field actors are reused for regions that are still baked and destroyed otherwise
+	TMap<FString, AMTraversalFieldActor*> ExistingFieldActors;
+	for (TActorIterator<AMTraversalFieldActor> It(World); It; ++It)
+	{
+		if (const UMTraversalFieldAsset* FieldAsset = It->GetFieldAsset())
+		{
+			ExistingFieldActors.Add(FieldAsset->GetOutermost()->GetName(), *It);
+		}
+		else
+		{
+			World->DestroyActor(*It);
+		}
+	}
+
+	const FString MapPackageName = World->GetOutermost()->GetName();
+	const FString FieldPackagePath = MapPackageName + TEXT("_TraversalField");
+
+	for (TPair<FIntVector, TArray<FMTraversalFieldCell>>& Region : RegionCells)
+	{
+		const FIntVector& RegionCoord = Region.Key;
+		const FString AssetName = FString::Printf(TEXT("TF_%d_%d_%d"), RegionCoord.X, RegionCoord.Y, RegionCoord.Z);
+		const FString PackageName = FieldPackagePath / AssetName;
+
+		UPackage* Package = CreatePackage(*PackageName);
+		Package->FullyLoad();
+
+		UMTraversalFieldAsset* FieldAsset = FindObject<UMTraversalFieldAsset>(Package, *AssetName);
+		if (FieldAsset == nullptr)
+		{
+			FieldAsset = NewObject<UMTraversalFieldAsset>(Package, *AssetName, RF_Public | RF_Standalone);
+		}
+
+		const FVector RegionMin = FVector(RegionCoord) * Settings.RegionSize;
+		const FBox RegionBounds(RegionMin, RegionMin + FVector(Settings.RegionSize));
+		FieldAsset->SetBakedData(RegionBounds, Settings.CellSize, Settings.Categories, MoveTemp(Region.Value));
+		FieldAsset->MarkPackageDirty();
+
+		AMTraversalFieldActor* FieldActor = nullptr;
+		if (!ExistingFieldActors.RemoveAndCopyValue(PackageName, FieldActor))
+		{
+			FActorSpawnParameters SpawnParameters;
+			SpawnParameters.Name = MakeUniqueObjectName(World->PersistentLevel, AMTraversalFieldActor::StaticClass(), *AssetName);
+			FieldActor = World->SpawnActor<AMTraversalFieldActor>(SpawnParameters);
+			FieldActor->SetActorLabel(AssetName);
+		}
+
+		FieldActor->SetFieldAsset(FieldAsset);
+
+		UE_LOG(LogMMovement, Display, TEXT("Traversal field bake: %s, %d cells, content hash %08x"), *PackageName,
+		       FieldAsset->GetCells().Num(), FieldAsset->ComputeContentHash());
+
+		if (bDump)
+		{
+			const FString DumpFilename = FPaths::ProjectSavedDir() / TEXT("TraversalField") / FPaths::GetBaseFilename(MapPackageName) + TEXT("_") +
+				AssetName + TEXT(".txt");
+			FFileHelper::SaveStringToFile(FieldAsset->ExportText(), *DumpFilename);
+		}
+	}
+
+	for (const TPair<FString, AMTraversalFieldActor*>& StaleFieldActor : ExistingFieldActors)
+	{
+		World->DestroyActor(StaleFieldActor.Value);
+	}
+
+	if (!UEditorLoadingAndSavingUtils::SaveDirtyPackages(true, true))
+	{
+		UE_LOG(LogMMovement, Error, TEXT("Traversal field bake: failed to save packages of %s"), *MapName);
+		return 1;
+	}
+
+	return 0;
+#else
+	return 1;
+#endif
+}
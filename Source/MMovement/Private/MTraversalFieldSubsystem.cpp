@@ -0,0 +1,108 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MTraversalFieldSubsystem.h"
+
+#include "MMovementSurfaceSubsystem.h"
+#include "MMovementTypes.h"
+#include "MTraversalFieldAsset.h"
+
+DECLARE_CYCLE_STAT(TEXT("Traversal Field Query"), STAT_MMovement_TraversalFieldQuery, STATGROUP_MMovement);
+
+void UMTraversalFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SurfaceSubsystem = Collection.InitializeDependency<UMMovementSurfaceSubsystem>();
+}
+
+void UMTraversalFieldSubsystem::Deinitialize()
+{
+	Fields.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMTraversalFieldSubsystem::RegisterField(UMTraversalFieldAsset* FieldAsset)
+{
+	if (FieldAsset == nullptr || Fields.ContainsByPredicate([FieldAsset](const FRegisteredField& Field) { return Field.FieldAsset == FieldAsset; }))
+		return;
+
+	FRegisteredField& Field = Fields.AddDefaulted_GetRef();
+	Field.FieldAsset = FieldAsset;
+
+	for (const FName& Category : FieldAsset->GetCategories())
+	{
+		const int32 CategoryBit = SurfaceSubsystem->RegisterCategory(Category);
+		Field.CategoryBits.Add(CategoryBit);
+
+		if (CategoryBit != INDEX_NONE)
+		{
+			Field.BakedCategoryMask |= 1ull << CategoryBit;
+		}
+	}
+}
+
+void UMTraversalFieldSubsystem::UnregisterField(const UMTraversalFieldAsset* FieldAsset)
+{
+	Fields.RemoveAllSwap([FieldAsset](const FRegisteredField& Field) { return Field.FieldAsset == FieldAsset; });
+}
+
+bool UMTraversalFieldSubsystem::FindSurface(const FVector& Location, const float MaxDistance, const FMMovementSurfaceFilter& SurfaceFilter,
+                                            bool& bOutFound, FMTraversalFieldSample& OutSample) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_TraversalFieldQuery);
+
+	bOutFound = false;
+
+	for (const FRegisteredField& Field : Fields)
+	{
+		const UMTraversalFieldAsset* FieldAsset = Field.FieldAsset;
+		if (!FieldAsset->GetBounds().IsInsideOrOn(Location))
+			continue;
+
+		// Surfaces with categories that weren't baked are missing from the field, it can't tell whether they are nearby
+		const uint64 FilterCategoryMask = SurfaceFilter.RequiredMask | SurfaceFilter.ExcludedMask;
+		if (SurfaceFilter.RequiredMask == 0 || (Field.BakedCategoryMask & FilterCategoryMask) != FilterCategoryMask)
+			return false;
+
+		const FMTraversalFieldCell* FieldCell = FieldAsset->FindCell(FieldAsset->GetCell(Location));
+		if (FieldCell == nullptr)
+			return true;
+
+		const uint64 CategoryMask = RemapCategoryMask(Field, FieldCell->CategoryMask);
+		if (!SurfaceFilter.Passes(CategoryMask))
+			return true;
+
+		const FVector SurfacePoint(FieldCell->SurfacePoint);
+		const float Distance = FVector::Dist(Location, SurfacePoint);
+		if (Distance > MaxDistance)
+			return true;
+
+		bOutFound = true;
+		OutSample.SurfacePoint = SurfacePoint;
+		OutSample.SurfaceNormal = FVector(FieldCell->SurfaceNormal);
+		OutSample.CategoryMask = CategoryMask;
+		OutSample.Distance = Distance;
+		return true;
+	}
+
+	return false;
+}
+
+uint64 UMTraversalFieldSubsystem::RemapCategoryMask(const FRegisteredField& Field, uint64 AssetCategoryMask) const
+{
+	uint64 CategoryMask = 0;
+	while (AssetCategoryMask != 0)
+	{
+		const int32 AssetBit = FMath::CountTrailingZeros64(AssetCategoryMask);
+		AssetCategoryMask &= AssetCategoryMask - 1;
+
+		if (Field.CategoryBits.IsValidIndex(AssetBit) && Field.CategoryBits[AssetBit] != INDEX_NONE)
+		{
+			CategoryMask |= 1ull << Field.CategoryBits[AssetBit];
+		}
+	}
+
+	return CategoryMask;
+}
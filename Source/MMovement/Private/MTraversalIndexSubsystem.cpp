@@ -0,0 +1,850 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MTraversalIndexSubsystem.h"
+
+#include "EngineUtils.h"
+#include "MMovementTypes.h"
+#include "PhysicsEngine/BodySetup.h"
+
+DECLARE_CYCLE_STAT(TEXT("Traversal Index Build"), STAT_MMovement_TraversalIndexBuild, STATGROUP_MMovement);
+DECLARE_CYCLE_STAT(TEXT("Traversal Index Query"), STAT_MMovement_TraversalIndexQuery, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Traversal Index Unreliable Queries"), STAT_MMovement_TraversalIndexUnreliableQueries, STATGROUP_MMovement);
+
+namespace MTraversalIndex
+{
+	// Top face of a ledge has to be walkable, wall face has to be close to vertical
+	constexpr float LedgeTopMinNormalZ = 0.7f;
+	constexpr float LedgeWallMaxAbsNormalZ = 0.3f;
+
+	// Ledge wall has to face against query facing within 60 degrees
+	constexpr float LedgeMinFacingDot = 0.5f;
+
+	// Vertices closer than this are treated as shared when matching triangle edges
+	constexpr float EdgeVertexTolerance = 0.1f;
+
+	// Components of pending categories indexed per frame, keeps categories registered mid-game from hitching
+	constexpr int32 MaxComponentsIndexedPerFrame = 32;
+
+	FIntVector QuantizeVertex(const FVector& Vertex)
+	{
+		return FIntVector(FMath::RoundToInt(Vertex.X / EdgeVertexTolerance),
+		                  FMath::RoundToInt(Vertex.Y / EdgeVertexTolerance),
+		                  FMath::RoundToInt(Vertex.Z / EdgeVertexTolerance));
+	}
+
+	bool IsVertexKeyLess(const FIntVector& A, const FIntVector& B)
+	{
+		if (A.X != B.X)
+			return A.X < B.X;
+
+		if (A.Y != B.Y)
+			return A.Y < B.Y;
+
+		return A.Z < B.Z;
+	}
+}
+
+void UMTraversalIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SurfaceSubsystem = Collection.InitializeDependency<UMMovementSurfaceSubsystem>();
+
+	CreatePhysicsStateHandle = UActorComponent::GlobalCreatePhysicsDelegate.AddUObject(
+		this, &UMTraversalIndexSubsystem::OnComponentPhysicsStateCreated);
+	DestroyPhysicsStateHandle = UActorComponent::GlobalDestroyPhysicsDelegate.AddUObject(
+		this, &UMTraversalIndexSubsystem::OnComponentPhysicsStateDestroyed);
+}
+
+void UMTraversalIndexSubsystem::Deinitialize()
+{
+	UActorComponent::GlobalCreatePhysicsDelegate.Remove(CreatePhysicsStateHandle);
+	UActorComponent::GlobalDestroyPhysicsDelegate.Remove(DestroyPhysicsStateHandle);
+
+	Triangles.Empty();
+	CellTriangles.Empty();
+	Ledges.Empty();
+	CellLedges.Empty();
+	UnreliableCellRefCounts.Empty();
+	ComponentEntries.Empty();
+	NonStaticComponents.Empty();
+	PendingComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMTraversalIndexSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Components registered before begin play are gathered by the first pass
+	bWorldBegunPlay = true;
+	bPendingComponentsGathered = false;
+}
+
+bool UMTraversalIndexSubsystem::RegisterSurfaceFilter(const FMMovementSurfaceFilter& SurfaceFilter)
+{
+	if (SurfaceFilter.RequiredMask == 0)
+		return false;
+
+	const uint64 NewCategoryMask = (SurfaceFilter.RequiredMask | SurfaceFilter.ExcludedMask) & ~(IndexedCategoryMask | PendingCategoryMask);
+	if (NewCategoryMask != 0)
+	{
+		PendingCategoryMask |= NewCategoryMask;
+		bPendingComponentsGathered = false;
+	}
+
+	return true;
+}
+
+bool UMTraversalIndexSubsystem::CanServeSurfaceFilter(const FMMovementSurfaceFilter& SurfaceFilter) const
+{
+	const uint64 FilterCategoryMask = SurfaceFilter.RequiredMask | SurfaceFilter.ExcludedMask;
+	return SurfaceFilter.RequiredMask != 0 && (IndexedCategoryMask & FilterCategoryMask) == FilterCategoryMask;
+}
+
+void UMTraversalIndexSubsystem::RegisterSurfaceComponent(UPrimitiveComponent* PrimitiveComponent)
+{
+	UnregisterSurfaceComponent(PrimitiveComponent);
+
+	uint64 CategoryMask;
+	if (!ShouldIndexComponent(PrimitiveComponent, CategoryMask))
+		return;
+
+	if (PrimitiveComponent->Mobility != EComponentMobility::Static)
+	{
+		NonStaticComponents.AddUnique(PrimitiveComponent);
+		return;
+	}
+
+	FComponentEntry& Entry = ComponentEntries.Add(PrimitiveComponent);
+
+	TArray<FVector> TriangleVertices;
+	const bool bSupported = GatherCollisionTriangles(PrimitiveComponent, TriangleVertices);
+
+	// Whole component is unreliable when any part of its collision can't be represented
+	if (!bSupported)
+	{
+		Entry.bUnreliable = true;
+
+		const FBox Bounds = PrimitiveComponent->Bounds.GetBox();
+		const FIntVector CellMin = GetCell(Bounds.Min);
+		const FIntVector CellMax = GetCell(Bounds.Max);
+		for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+		{
+			for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+			{
+				for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+				{
+					const FIntVector Cell(X, Y, Z);
+					UnreliableCellRefCounts.FindOrAdd(Cell)++;
+					Entry.Cells.Add(Cell);
+				}
+			}
+		}
+
+		return;
+	}
+
+	for (int32 i = 0; i + 2 < TriangleVertices.Num(); i += 3)
+	{
+		const FVector& A = TriangleVertices[i];
+		const FVector& B = TriangleVertices[i + 1];
+		const FVector& C = TriangleVertices[i + 2];
+
+		const FVector Normal = FVector::CrossProduct(B - A, C - A).GetSafeNormal();
+		if (Normal.IsZero())
+			continue;
+
+		FMTraversalIndexTriangle Triangle;
+		Triangle.Vertices[0] = FVector3f(A);
+		Triangle.Vertices[1] = FVector3f(B);
+		Triangle.Vertices[2] = FVector3f(C);
+		Triangle.Normal = FVector3f(Normal);
+		Triangle.CategoryMask = CategoryMask;
+		Triangle.Component = PrimitiveComponent;
+
+		const int32 TriangleIndex = Triangles.Add(Triangle);
+		Entry.TriangleIndices.Add(TriangleIndex);
+
+		const FBox TriangleBounds(TArray<FVector>{A, B, C});
+		const FIntVector CellMin = GetCell(TriangleBounds.Min);
+		const FIntVector CellMax = GetCell(TriangleBounds.Max);
+		for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+		{
+			for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+			{
+				for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+				{
+					const FIntVector Cell(X, Y, Z);
+					CellTriangles.FindOrAdd(Cell).Add(TriangleIndex);
+					Entry.Cells.Add(Cell);
+				}
+			}
+		}
+	}
+
+	ExtractLedges(Entry, PrimitiveComponent, CategoryMask);
+}
+
+void UMTraversalIndexSubsystem::UnregisterSurfaceComponent(const UPrimitiveComponent* PrimitiveComponent)
+{
+	NonStaticComponents.RemoveSwap(const_cast<UPrimitiveComponent*>(PrimitiveComponent));
+
+	FComponentEntry Entry;
+	if (!ComponentEntries.RemoveAndCopyValue(PrimitiveComponent, Entry))
+		return;
+
+	if (Entry.bUnreliable)
+	{
+		for (const FIntVector& Cell : Entry.Cells)
+		{
+			int32& RefCount = UnreliableCellRefCounts.FindChecked(Cell);
+			if (--RefCount == 0)
+				UnreliableCellRefCounts.Remove(Cell);
+		}
+
+		return;
+	}
+
+	for (const FIntVector& Cell : Entry.Cells)
+	{
+		if (TArray<int32>* CellTriangleIndices = CellTriangles.Find(Cell))
+		{
+			for (const int32 TriangleIndex : Entry.TriangleIndices)
+			{
+				CellTriangleIndices->RemoveSwap(TriangleIndex);
+			}
+
+			if (CellTriangleIndices->IsEmpty())
+				CellTriangles.Remove(Cell);
+		}
+
+		if (TArray<int32>* CellLedgeIndices = CellLedges.Find(Cell))
+		{
+			for (const int32 LedgeIndex : Entry.LedgeIndices)
+			{
+				CellLedgeIndices->RemoveSwap(LedgeIndex);
+			}
+
+			if (CellLedgeIndices->IsEmpty())
+				CellLedges.Remove(Cell);
+		}
+	}
+
+	for (const int32 TriangleIndex : Entry.TriangleIndices)
+	{
+		Triangles.RemoveAt(TriangleIndex);
+	}
+
+	for (const int32 LedgeIndex : Entry.LedgeIndices)
+	{
+		Ledges.RemoveAt(LedgeIndex);
+	}
+}
+
+bool UMTraversalIndexSubsystem::QueryCapsule(const FVector& Start, const FVector& End, const float Radius, const float HalfHeight,
+                                             const FMMovementSurfaceFilter& SurfaceFilter, TArray<FHitResult>& OutHits)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_TraversalIndexQuery);
+
+	EnsureIndexBuilt();
+
+	if (!CanServeSurfaceFilter(SurfaceFilter))
+		return false;
+
+	const FVector Extent(Radius, Radius, FMath::Max(HalfHeight, Radius));
+	const FBox Bounds = FBox(Start - Extent, Start + Extent) + FBox(End - Extent, End + Extent);
+	const FIntVector CellMin = GetCell(Bounds.Min);
+	const FIntVector CellMax = GetCell(Bounds.Max);
+
+	if (!IsRegionReliable(Bounds, CellMin, CellMax))
+	{
+		INC_DWORD_STAT(STAT_MMovement_TraversalIndexUnreliableQueries);
+		return false;
+	}
+
+	// Sweep is sampled in steps no longer than the radius so no surface is skipped between two steps.
+	// Longer sweeps would need longer steps and could tunnel through thin walls, they are left to physics
+	constexpr int32 MaxSweepSteps = 16;
+	const int32 SweepSteps = FMath::Max(FMath::CeilToInt32(FVector::Dist(Start, End) / FMath::Max(Radius, 1.f)), 1);
+	if (SweepSteps > MaxSweepSteps)
+		return false;
+
+	// Capsule is approximated with spheres at both ends and in the middle of its segment
+	const float SegmentHalfLength = FMath::Max(HalfHeight - Radius, 0.f);
+	const FVector SegmentOffsets[3] = {
+		-FVector::UpVector * SegmentHalfLength,
+		FVector::ZeroVector,
+		FVector::UpVector * SegmentHalfLength
+	};
+
+	struct FClosestSurface
+	{
+		const FMTraversalIndexTriangle* Triangle;
+		FVector ImpactPoint;
+		float DistanceSquared;
+		int32 SweepStep;
+	};
+
+	TArray<FClosestSurface, TInlineAllocator<8>> ClosestSurfaces;
+
+	// Earliest step touching a surface failing the filter, it blocks the sweep like it would block a physics query
+	int32 BlockingSweepStep = MAX_int32;
+
+	++QueryStamp;
+	for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+	{
+		for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+		{
+			for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+			{
+				const TArray<int32>* CellTriangleIndices = CellTriangles.Find(FIntVector(X, Y, Z));
+				if (CellTriangleIndices == nullptr)
+					continue;
+
+				for (const int32 TriangleIndex : *CellTriangleIndices)
+				{
+					const FMTraversalIndexTriangle& Triangle = Triangles[TriangleIndex];
+					if (Triangle.QueryStamp == QueryStamp)
+						continue;
+
+					Triangle.QueryStamp = QueryStamp;
+
+					const FVector A(Triangle.Vertices[0]);
+					const FVector B(Triangle.Vertices[1]);
+					const FVector C(Triangle.Vertices[2]);
+
+					// Earliest step of the sweep that touches the triangle
+					FVector ImpactPoint = FVector::ZeroVector;
+					float DistanceSquared = MAX_flt;
+					int32 SweepStep = 0;
+					for (; SweepStep <= SweepSteps; ++SweepStep)
+					{
+						const FVector StepCenter = FMath::Lerp(Start, End, static_cast<float>(SweepStep) / SweepSteps);
+						for (const FVector& SegmentOffset : SegmentOffsets)
+						{
+							const FVector SamplePoint = StepCenter + SegmentOffset;
+							const FVector ClosestPoint = FMath::ClosestPointOnTriangleToPoint(SamplePoint, A, B, C);
+							const float SampleDistanceSquared = FVector::DistSquared(SamplePoint, ClosestPoint);
+							if (SampleDistanceSquared < DistanceSquared)
+							{
+								DistanceSquared = SampleDistanceSquared;
+								ImpactPoint = ClosestPoint;
+							}
+						}
+
+						if (DistanceSquared <= FMath::Square(Radius))
+							break;
+					}
+
+					if (SweepStep > SweepSteps)
+						continue;
+
+					if (!SurfaceFilter.Passes(Triangle.CategoryMask))
+					{
+						BlockingSweepStep = FMath::Min(BlockingSweepStep, SweepStep);
+						continue;
+					}
+
+					FClosestSurface* ClosestSurface = ClosestSurfaces.FindByPredicate([&Triangle](const FClosestSurface& Surface)
+					{
+						return Surface.Triangle->Component == Triangle.Component;
+					});
+
+					if (ClosestSurface == nullptr)
+					{
+						ClosestSurfaces.Add({&Triangle, ImpactPoint, DistanceSquared, SweepStep});
+					}
+					else if (SweepStep < ClosestSurface->SweepStep
+						|| (SweepStep == ClosestSurface->SweepStep && DistanceSquared < ClosestSurface->DistanceSquared))
+					{
+						*ClosestSurface = {&Triangle, ImpactPoint, DistanceSquared, SweepStep};
+					}
+				}
+			}
+		}
+	}
+
+	OutHits.Reset(ClosestSurfaces.Num());
+	for (const FClosestSurface& ClosestSurface : ClosestSurfaces)
+	{
+		if (ClosestSurface.SweepStep > BlockingSweepStep)
+			continue;
+
+		FHitResult& Hit = OutHits.Add_GetRef(MakeHit(*ClosestSurface.Triangle, Start, End, ClosestSurface.ImpactPoint));
+		Hit.Time = static_cast<float>(ClosestSurface.SweepStep) / SweepSteps;
+		Hit.Location = FMath::Lerp(Start, End, Hit.Time);
+	}
+
+	return true;
+}
+
+bool UMTraversalIndexSubsystem::LineTrace(const FVector& Start, const FVector& End, const FMMovementSurfaceFilter& SurfaceFilter,
+                                          bool& bOutHit, FHitResult& OutHit)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_TraversalIndexQuery);
+
+	bOutHit = false;
+
+	EnsureIndexBuilt();
+
+	if (!CanServeSurfaceFilter(SurfaceFilter))
+		return false;
+
+	const FBox Bounds(TArray<FVector>{Start, End});
+	const FIntVector CellMin = GetCell(Bounds.Min);
+	const FIntVector CellMax = GetCell(Bounds.Max);
+
+	if (!IsRegionReliable(Bounds, CellMin, CellMax))
+	{
+		INC_DWORD_STAT(STAT_MMovement_TraversalIndexUnreliableQueries);
+		return false;
+	}
+
+	const FMTraversalIndexTriangle* ClosestTriangle = nullptr;
+	FVector ClosestImpactPoint = FVector::ZeroVector;
+	float ClosestDistanceSquared = MAX_flt;
+
+	++QueryStamp;
+	for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+	{
+		for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+		{
+			for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+			{
+				const TArray<int32>* CellTriangleIndices = CellTriangles.Find(FIntVector(X, Y, Z));
+				if (CellTriangleIndices == nullptr)
+					continue;
+
+				for (const int32 TriangleIndex : *CellTriangleIndices)
+				{
+					const FMTraversalIndexTriangle& Triangle = Triangles[TriangleIndex];
+					if (Triangle.QueryStamp == QueryStamp)
+						continue;
+
+					Triangle.QueryStamp = QueryStamp;
+
+					FVector ImpactPoint;
+					FVector TriangleNormal;
+					if (!FMath::SegmentTriangleIntersection(Start, End, FVector(Triangle.Vertices[0]), FVector(Triangle.Vertices[1]),
+					                                        FVector(Triangle.Vertices[2]), ImpactPoint, TriangleNormal))
+					{
+						continue;
+					}
+
+					const float DistanceSquared = FVector::DistSquared(Start, ImpactPoint);
+					if (DistanceSquared < ClosestDistanceSquared)
+					{
+						ClosestTriangle = &Triangle;
+						ClosestImpactPoint = ImpactPoint;
+						ClosestDistanceSquared = DistanceSquared;
+					}
+				}
+			}
+		}
+	}
+
+	// Closest surface failing the filter occludes the surfaces behind it
+	if (ClosestTriangle != nullptr && SurfaceFilter.Passes(ClosestTriangle->CategoryMask))
+	{
+		bOutHit = true;
+		OutHit = MakeHit(*ClosestTriangle, Start, End, ClosestImpactPoint);
+	}
+
+	return true;
+}
+
+bool UMTraversalIndexSubsystem::FindLedgeAbove(const FVector& Location, const FVector& Facing, const float Radius, const float MaxHeight,
+                                               const FMMovementSurfaceFilter& SurfaceFilter, bool& bOutFound,
+                                               FMTraversalIndexLedgeHit& OutLedge)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_TraversalIndexQuery);
+
+	bOutFound = false;
+
+	EnsureIndexBuilt();
+
+	if (!CanServeSurfaceFilter(SurfaceFilter))
+		return false;
+
+	const FBox Bounds(Location - FVector(Radius, Radius, 0), Location + FVector(Radius, Radius, MaxHeight));
+	const FIntVector CellMin = GetCell(Bounds.Min);
+	const FIntVector CellMax = GetCell(Bounds.Max);
+
+	if (!IsRegionReliable(Bounds, CellMin, CellMax))
+	{
+		INC_DWORD_STAT(STAT_MMovement_TraversalIndexUnreliableQueries);
+		return false;
+	}
+
+	const FVector HorizontalFacing = FVector(Facing.X, Facing.Y, 0).GetSafeNormal();
+
+	const FMTraversalIndexLedge* LowestLedge = nullptr;
+	FVector LowestLedgeLocation = FVector::ZeroVector;
+
+	++QueryStamp;
+	for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+	{
+		for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+		{
+			for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+			{
+				const TArray<int32>* CellLedgeIndices = CellLedges.Find(FIntVector(X, Y, Z));
+				if (CellLedgeIndices == nullptr)
+					continue;
+
+				for (const int32 LedgeIndex : *CellLedgeIndices)
+				{
+					const FMTraversalIndexLedge& Ledge = Ledges[LedgeIndex];
+					if (Ledge.QueryStamp == QueryStamp)
+						continue;
+
+					Ledge.QueryStamp = QueryStamp;
+
+					if (!SurfaceFilter.Passes(Ledge.CategoryMask))
+						continue;
+
+					if (FVector::DotProduct(-FVector(Ledge.WallNormal), HorizontalFacing) < MTraversalIndex::LedgeMinFacingDot)
+						continue;
+
+					const FVector LedgeLocation = FMath::ClosestPointOnSegment(Location, FVector(Ledge.Start), FVector(Ledge.End));
+					if (LedgeLocation.Z < Location.Z || LedgeLocation.Z > Location.Z + MaxHeight)
+						continue;
+
+					if (FVector::DistSquared2D(Location, LedgeLocation) > FMath::Square(Radius))
+						continue;
+
+					if (LowestLedge == nullptr || LedgeLocation.Z < LowestLedgeLocation.Z)
+					{
+						LowestLedge = &Ledge;
+						LowestLedgeLocation = LedgeLocation;
+					}
+				}
+			}
+		}
+	}
+
+	if (LowestLedge != nullptr)
+	{
+		bOutFound = true;
+		OutLedge.Location = LowestLedgeLocation;
+		OutLedge.WallNormal = FVector(LowestLedge->WallNormal);
+		OutLedge.Height = LowestLedgeLocation.Z - Location.Z;
+		OutLedge.Component = LowestLedge->Component.ResolveObjectPtr();
+	}
+
+	return true;
+}
+
+bool UMTraversalIndexSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMTraversalIndexSubsystem::OnComponentPhysicsStateCreated(UActorComponent* Component)
+{
+	// Components registered before begin play are gathered by the first pass
+	if (!bWorldBegunPlay || Component->GetWorld() != GetWorld())
+		return;
+
+	if (UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(Component))
+	{
+		SurfaceSubsystem->InvalidateSurfaceCategoryMask(PrimitiveComponent);
+		RegisterSurfaceComponent(PrimitiveComponent);
+	}
+}
+
+void UMTraversalIndexSubsystem::OnComponentPhysicsStateDestroyed(UActorComponent* Component)
+{
+	if (!bWorldBegunPlay || Component->GetWorld() != GetWorld())
+		return;
+
+	if (const UPrimitiveComponent* PrimitiveComponent = Cast<UPrimitiveComponent>(Component))
+	{
+		UnregisterSurfaceComponent(PrimitiveComponent);
+	}
+}
+
+void UMTraversalIndexSubsystem::EnsureIndexBuilt()
+{
+	if (PendingCategoryMask == 0 || !bWorldBegunPlay || PendingIndexFrame == GFrameCounter)
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_MMovement_TraversalIndexBuild);
+
+	PendingIndexFrame = GFrameCounter;
+
+	// Components with indexed categories are already in, components created from now on are added by physics state callbacks.
+	// Only category masks are resolved here, collision of gathered components is extracted in slices below
+	if (!bPendingComponentsGathered)
+	{
+		bPendingComponentsGathered = true;
+		PendingComponents.Reset();
+
+		for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+		{
+			It->ForEachComponent<UPrimitiveComponent>(false, [this](UPrimitiveComponent* PrimitiveComponent)
+			{
+				uint64 CategoryMask;
+				if (PrimitiveComponent->IsPhysicsStateCreated() && !IsComponentIndexed(PrimitiveComponent)
+					&& ShouldIndexComponent(PrimitiveComponent, CategoryMask))
+				{
+					PendingComponents.Add(PrimitiveComponent);
+				}
+			});
+		}
+	}
+
+	int32 NumIndexed = 0;
+	while (!PendingComponents.IsEmpty() && NumIndexed < MTraversalIndex::MaxComponentsIndexedPerFrame)
+	{
+		UPrimitiveComponent* PrimitiveComponent = PendingComponents.Pop().Get();
+		if (PrimitiveComponent == nullptr || !PrimitiveComponent->IsPhysicsStateCreated() || IsComponentIndexed(PrimitiveComponent))
+			continue;
+
+		RegisterSurfaceComponent(PrimitiveComponent);
+		NumIndexed++;
+	}
+
+	if (!PendingComponents.IsEmpty())
+		return;
+
+	IndexedCategoryMask |= PendingCategoryMask;
+	PendingCategoryMask = 0;
+	bPendingComponentsGathered = false;
+
+	UE_LOG(LogMMovement, Log, TEXT("Traversal index built: %d components, %d triangles, %d ledges, %d cells"),
+	       ComponentEntries.Num(), Triangles.Num(), Ledges.Num(), CellTriangles.Num());
+}
+
+bool UMTraversalIndexSubsystem::IsComponentIndexed(const UPrimitiveComponent* PrimitiveComponent) const
+{
+	return ComponentEntries.Contains(PrimitiveComponent) || NonStaticComponents.Contains(PrimitiveComponent);
+}
+
+void UMTraversalIndexSubsystem::ExtractLedges(FComponentEntry& Entry, const UPrimitiveComponent* PrimitiveComponent,
+                                              const uint64 CategoryMask)
+{
+	// Triangles of the component sharing an edge, keyed by quantized edge vertices in ascending order
+	TMap<TPair<FIntVector, FIntVector>, int32> EdgeTriangles;
+	EdgeTriangles.Reserve(Entry.TriangleIndices.Num() * 3);
+
+	for (const int32 TriangleIndex : Entry.TriangleIndices)
+	{
+		const FMTraversalIndexTriangle& Triangle = Triangles[TriangleIndex];
+
+		for (int32 EdgeIndex = 0; EdgeIndex < 3; ++EdgeIndex)
+		{
+			const FVector3f& EdgeStart = Triangle.Vertices[EdgeIndex];
+			const FVector3f& EdgeEnd = Triangle.Vertices[(EdgeIndex + 1) % 3];
+
+			FIntVector KeyA = MTraversalIndex::QuantizeVertex(FVector(EdgeStart));
+			FIntVector KeyB = MTraversalIndex::QuantizeVertex(FVector(EdgeEnd));
+			if (MTraversalIndex::IsVertexKeyLess(KeyB, KeyA))
+			{
+				Swap(KeyA, KeyB);
+			}
+
+			const TPair<FIntVector, FIntVector> EdgeKey(KeyA, KeyB);
+			const int32* OtherTriangleIndex = EdgeTriangles.Find(EdgeKey);
+			if (OtherTriangleIndex == nullptr)
+			{
+				EdgeTriangles.Add(EdgeKey, TriangleIndex);
+				continue;
+			}
+
+			const FMTraversalIndexTriangle& OtherTriangle = Triangles[*OtherTriangleIndex];
+
+			const FMTraversalIndexTriangle* TopTriangle = nullptr;
+			const FMTraversalIndexTriangle* WallTriangle = nullptr;
+			if (Triangle.Normal.Z >= MTraversalIndex::LedgeTopMinNormalZ
+				&& FMath::Abs(OtherTriangle.Normal.Z) <= MTraversalIndex::LedgeWallMaxAbsNormalZ)
+			{
+				TopTriangle = &Triangle;
+				WallTriangle = &OtherTriangle;
+			}
+			else if (OtherTriangle.Normal.Z >= MTraversalIndex::LedgeTopMinNormalZ
+				&& FMath::Abs(Triangle.Normal.Z) <= MTraversalIndex::LedgeWallMaxAbsNormalZ)
+			{
+				TopTriangle = &OtherTriangle;
+				WallTriangle = &Triangle;
+			}
+
+			if (TopTriangle == nullptr)
+				continue;
+
+			// Edge is convex when the top face lies behind the wall
+			const FVector EdgeMiddle = FVector(EdgeStart + EdgeEnd) * 0.5f;
+			const FVector TopCentroid = FVector(TopTriangle->Vertices[0] + TopTriangle->Vertices[1] + TopTriangle->Vertices[2]) / 3;
+			if (FVector::DotProduct(FVector(WallTriangle->Normal), TopCentroid - EdgeMiddle) >= 0)
+				continue;
+
+			FMTraversalIndexLedge Ledge;
+			Ledge.Start = EdgeStart;
+			Ledge.End = EdgeEnd;
+			Ledge.WallNormal = FVector3f(WallTriangle->Normal.X, WallTriangle->Normal.Y, 0).GetSafeNormal();
+			Ledge.CategoryMask = CategoryMask;
+			Ledge.Component = PrimitiveComponent;
+
+			const int32 LedgeIndex = Ledges.Add(Ledge);
+			Entry.LedgeIndices.Add(LedgeIndex);
+
+			const FBox LedgeBounds(TArray<FVector>{FVector(EdgeStart), FVector(EdgeEnd)});
+			const FIntVector CellMin = GetCell(LedgeBounds.Min);
+			const FIntVector CellMax = GetCell(LedgeBounds.Max);
+			for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+			{
+				for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+				{
+					for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+					{
+						const FIntVector Cell(X, Y, Z);
+						CellLedges.FindOrAdd(Cell).Add(LedgeIndex);
+						Entry.Cells.Add(Cell);
+					}
+				}
+			}
+		}
+	}
+}
+
+bool UMTraversalIndexSubsystem::ShouldIndexComponent(const UPrimitiveComponent* PrimitiveComponent, uint64& OutCategoryMask) const
+{
+	OutCategoryMask = 0;
+
+	const uint64 CategoryMask = IndexedCategoryMask | PendingCategoryMask;
+	if (!IsValid(PrimitiveComponent) || CategoryMask == 0)
+		return false;
+
+	if (PrimitiveComponent->GetCollisionEnabled() == ECollisionEnabled::NoCollision)
+		return false;
+
+	OutCategoryMask = SurfaceSubsystem->GetSurfaceCategoryMask(PrimitiveComponent);
+	return (OutCategoryMask & CategoryMask) != 0;
+}
+
+bool UMTraversalIndexSubsystem::GatherCollisionTriangles(const UPrimitiveComponent* PrimitiveComponent,
+                                                         TArray<FVector>& OutTriangleVertices)
+{
+	UBodySetup* BodySetup = PrimitiveComponent->GetBodySetup();
+	if (BodySetup == nullptr || BodySetup->CollisionTraceFlag == CTF_UseComplexAsSimple)
+		return false;
+
+	const FKAggregateGeom& AggGeom = BodySetup->AggGeom;
+	if (AggGeom.SphereElems.Num() > 0 || AggGeom.SphylElems.Num() > 0 || AggGeom.TaperedCapsuleElems.Num() > 0
+		|| AggGeom.LevelSetElems.Num() > 0)
+	{
+		return false;
+	}
+
+	if (AggGeom.BoxElems.Num() == 0 && AggGeom.ConvexElems.Num() == 0)
+		return false;
+
+	const FTransform& ComponentTransform = PrimitiveComponent->GetComponentTransform();
+
+	for (const FKBoxElem& BoxElem : AggGeom.BoxElems)
+	{
+		const FTransform BoxTransform = BoxElem.GetTransform() * ComponentTransform;
+		const FVector HalfExtent(BoxElem.X * 0.5f, BoxElem.Y * 0.5f, BoxElem.Z * 0.5f);
+
+		FVector Corners[8];
+		for (int32 CornerIndex = 0; CornerIndex < 8; ++CornerIndex)
+		{
+			const FVector LocalCorner((CornerIndex & 1) ? HalfExtent.X : -HalfExtent.X,
+			                          (CornerIndex & 2) ? HalfExtent.Y : -HalfExtent.Y,
+			                          (CornerIndex & 4) ? HalfExtent.Z : -HalfExtent.Z);
+			Corners[CornerIndex] = BoxTransform.TransformPosition(LocalCorner);
+		}
+
+		// Two triangles per face, wound so normals point out of the box
+		static constexpr int32 BoxTriangleCorners[36] = {
+			0, 2, 1, 1, 2, 3, // -Z
+			4, 5, 6, 5, 7, 6, // +Z
+			0, 1, 4, 1, 5, 4, // -Y
+			2, 6, 3, 3, 6, 7, // +Y
+			0, 4, 2, 2, 4, 6, // -X
+			1, 3, 5, 3, 7, 5 // +X
+		};
+
+		const bool bMirrored = BoxTransform.GetDeterminant() < 0;
+		for (int32 i = 0; i < 36; i += 3)
+		{
+			OutTriangleVertices.Add(Corners[BoxTriangleCorners[i]]);
+			OutTriangleVertices.Add(Corners[BoxTriangleCorners[bMirrored ? i + 2 : i + 1]]);
+			OutTriangleVertices.Add(Corners[BoxTriangleCorners[bMirrored ? i + 1 : i + 2]]);
+		}
+	}
+
+	for (const FKConvexElem& ConvexElem : AggGeom.ConvexElems)
+	{
+		// Index data is needed to know faces of the hull
+		if (ConvexElem.IndexData.Num() < 3 || ConvexElem.VertexData.Num() < 3)
+			return false;
+
+		const FTransform ConvexTransform = ConvexElem.GetTransform() * ComponentTransform;
+		const bool bMirrored = ConvexTransform.GetDeterminant() < 0;
+		for (int32 i = 0; i + 2 < ConvexElem.IndexData.Num(); i += 3)
+		{
+			const FVector A = ConvexTransform.TransformPosition(ConvexElem.VertexData[ConvexElem.IndexData[i]]);
+			const FVector B = ConvexTransform.TransformPosition(ConvexElem.VertexData[ConvexElem.IndexData[i + 1]]);
+			const FVector C = ConvexTransform.TransformPosition(ConvexElem.VertexData[ConvexElem.IndexData[i + 2]]);
+
+			OutTriangleVertices.Add(A);
+			OutTriangleVertices.Add(bMirrored ? C : B);
+			OutTriangleVertices.Add(bMirrored ? B : C);
+		}
+	}
+
+	return true;
+}
+
+bool UMTraversalIndexSubsystem::IsRegionReliable(const FBox& Bounds, const FIntVector CellMin, const FIntVector CellMax) const
+{
+	if (!UnreliableCellRefCounts.IsEmpty())
+	{
+		for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+		{
+			for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+			{
+				for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+				{
+					if (UnreliableCellRefCounts.Contains(FIntVector(X, Y, Z)))
+						return false;
+				}
+			}
+		}
+	}
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& NonStaticComponent : NonStaticComponents)
+	{
+		if (NonStaticComponent.IsValid() && NonStaticComponent->Bounds.GetBox().Intersect(Bounds))
+			return false;
+	}
+
+	return true;
+}
+
+FIntVector UMTraversalIndexSubsystem::GetCell(const FVector& Location)
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize),
+	                  FMath::FloorToInt(Location.Y / CellSize),
+	                  FMath::FloorToInt(Location.Z / CellSize));
+}
+
+FHitResult UMTraversalIndexSubsystem::MakeHit(const FMTraversalIndexTriangle& Triangle, const FVector& TraceStart, const FVector& TraceEnd,
+                                              const FVector& ImpactPoint) const
+{
+	UPrimitiveComponent* PrimitiveComponent = Triangle.Component.ResolveObjectPtr();
+
+	FHitResult Hit(PrimitiveComponent != nullptr ? PrimitiveComponent->GetOwner() : nullptr, PrimitiveComponent, ImpactPoint,
+	               FVector(Triangle.Normal));
+	Hit.bBlockingHit = true;
+	Hit.TraceStart = TraceStart;
+	Hit.TraceEnd = TraceEnd;
+	Hit.ImpactNormal = FVector(Triangle.Normal);
+	Hit.Distance = FVector::Dist(TraceStart, ImpactPoint);
+
+	return Hit;
+}
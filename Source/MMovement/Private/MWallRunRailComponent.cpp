@@ -0,0 +1,49 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MWallRunRailComponent.h"
+
+UMWallRunRailComponent::UMWallRunRailComponent()
+{
+	SetMobility(EComponentMobility::Static);
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+#if WITH_EDITORONLY_DATA
+	EditorUnselectedSplineSegmentColor = FLinearColor(0.2f, 0.8f, 1.f);
+#endif
+}
+
+void UMWallRunRailComponent::GetRunnerFrameAtDistance(const float Distance, FVector& OutLocation, FVector& OutWallNormal,
+                                                      FVector& OutDirection) const
+{
+	const FVector RailLocation = GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	const FVector RailTangent = GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+
+	OutDirection = FVector(RailTangent.X, RailTangent.Y, 0).GetSafeNormal();
+	OutWallNormal = FVector::CrossProduct(FVector::UpVector, OutDirection) * (bFlipWallNormal ? -1 : 1);
+	OutLocation = RailLocation + OutWallNormal * OffsetFromWall;
+}
+
+float UMWallRunRailComponent::FindDistanceClosestToLocation(const FVector& Location) const
+{
+	const float InputKey = FindInputKeyClosestToWorldLocation(Location);
+	return GetDistanceAlongSplineAtSplineInputKey(InputKey);
+}
+
+bool UMWallRunRailComponent::WrapDistance(float& InOutDistance) const
+{
+	const float SplineLength = GetSplineLength();
+	if (InOutDistance >= 0 && InOutDistance <= SplineLength)
+		return true;
+
+	if (!IsClosedLoop() || SplineLength <= UE_KINDA_SMALL_NUMBER)
+		return false;
+
+	InOutDistance = FMath::Fmod(InOutDistance, SplineLength);
+	if (InOutDistance < 0)
+	{
+		InOutDistance += SplineLength;
+	}
+
+	return true;
+}
@@ -7,6 +7,7 @@
 #include "MMath.h"
 #include "MCharacterMovementComponent.h"
 #include "MControlledLaunchManager.h"
+#include "MDebug.h"
 #include "MMovementTypes.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/Character.h"
@@ -14,10 +15,23 @@
 #include "MovementModes/MMovementMode_VerticalWallRun.h"
 #include "MovementModes/MMovementMode_WallRun.h"
 
+UMMovementMode_Dash::UMMovementMode_Dash()
+{
+	// Dash can only start after input trigger
+	WakeConditions = static_cast<int32>(EMMovementModeWakeCondition::InputTriggered | EMMovementModeWakeCondition::TimerExpired);
+}
+
 void UMMovementMode_Dash::Initialize_Implementation()
 {
 	Super::Initialize_Implementation();
 
+	if (DashConfig.DistanceCurve == nullptr)
+	{
+		M::Debug::LogUserError(LogMMovement, TEXT("MovementMode_Dash: Distance Curve is not set, dash won't move character"), CharacterOwner);
+	}
+
+	DistanceCurveBaked.Bake(DashConfig.DistanceCurve);
+
 	// Bind input action
 	UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(CharacterOwner->InputComponent);
 	if (!EnhancedInputComponent)
@@ -41,29 +55,23 @@ void UMMovementMode_Dash::Tick_Implementation(float DeltaTime)
 {
 	Super::Tick_Implementation(DeltaTime);
 
-	RuntimeData.CooldownTimer.Tick(DeltaTime);
+	TickTimerWithActivationWake(RuntimeData.CooldownTimer, DeltaTime);
 
 	if (DashConfig.bEnableDashCharges)
 	{
 		if (DashConfig.bRestoreChargesOnGround && MovementComponent->IsMovingOnGround())
 			ResetCharges(true);
 
-		UMMovementMode_Base* ActiveCustomMovementModeInstance = MovementComponent->GetActiveCustomMovementModeInstance();
-		if (IsValid(ActiveCustomMovementModeInstance))
-		{
-			if (DashConfig.bRestoreChargesOnWallRun && ActiveCustomMovementModeInstance->IsA<UMMovementMode_WallRun>())
-			{
-				ResetCharges(true);
-			}
-
-			if (DashConfig.bRestoreChargesOnVerticalWallRun && ActiveCustomMovementModeInstance->IsA<UMMovementMode_VerticalWallRun>())
-			{
-				ResetCharges(true);
-			}
-		}
+		if ((ChargeRestoreMovementModeMask & MovementComponent->GetActiveMovementModeMask()) != 0)
+			ResetCharges(true);
 	}
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	// Keep evaluating CanStart until dash input is consumed, but only while cooldown and charges let the dash start
+	const bool bHasCharge = !DashConfig.bEnableDashCharges || RuntimeData.ChargesLeft > 0;
+	if (RuntimeData.bWantsToDash && RuntimeData.CooldownTimer.IsCompleted() && bHasCharge)
+		WakeActivationCheck(EMMovementModeWakeCondition::InputTriggered);
+
+	if (ShouldShowMovementDebugs())
 	{
 		if (!RuntimeData.CooldownTimer.IsCompleted())
 		{
@@ -79,23 +87,23 @@ void UMMovementMode_Dash::Tick_Implementation(float DeltaTime)
 	}
 }
 
-bool UMMovementMode_Dash::CanStart_Implementation(FString& OutFailReason)
+bool UMMovementMode_Dash::CanStart_Implementation(FMMovementMode_FailReason& OutFailReason)
 {
 	if (!RuntimeData.CooldownTimer.IsCompleted())
 	{
-		OutFailReason = TEXT("Cooldown");
+		OutFailReason = EMMovementMode_FailReasonCode::Cooldown;
 		return false;
 	}
 
 	if (!RuntimeData.bWantsToDash)
 	{
-		OutFailReason = TEXT("Not triggered by input");
+		OutFailReason = EMMovementMode_FailReasonCode::NotTriggeredByInput;
 		return false;
 	}
 
 	if (DashConfig.bEnableDashCharges && RuntimeData.ChargesLeft == 0)
 	{
-		OutFailReason = TEXT("Charges depleted");
+		OutFailReason = EMMovementMode_FailReasonCode::ChargesDepleted;
 		return false;
 	}
 
@@ -127,7 +135,7 @@ void UMMovementMode_Dash::Phys_Implementation(float DeltaTime, int32 Iterations)
 	float DeltaTimeClamped = FMath::Min(RuntimeData.DurationTimer.GetTimeLeft(), DeltaTime);
 	RuntimeData.DurationTimer.Tick(DeltaTimeClamped);
 
-	const float DistanceNormalized = DashConfig.DistanceCurve->GetFloatValue(RuntimeData.DurationTimer.GetProgressNormalized());
+	const float DistanceNormalized = DistanceCurveBaked.Evaluate(RuntimeData.DurationTimer.GetProgressNormalized());
 	const float Distance = DistanceNormalized * DashConfig.Distance;
 	const FVector LocationTarget = RuntimeData.LocationInitial + RuntimeData.DashDirection * Distance;
 	const FVector VelocityTarget = MMath::FromToVector(UpdatedComponent->GetComponentLocation(), LocationTarget);
@@ -182,9 +190,36 @@ void UMMovementMode_Dash::End_Implementation()
 {
 	Super::End_Implementation();
 
+	ActivateCooldown();
+}
+
+void UMMovementMode_Dash::OnMovementModesRegistered()
+{
+	Super::OnMovementModesRegistered();
+
+	ChargeRestoreMovementModeMask = 0;
+
+	if (DashConfig.bRestoreChargesOnWallRun)
+		ChargeRestoreMovementModeMask |= MovementComponent->GetMovementModeMask(UMMovementMode_WallRun::StaticClass());
+
+	if (DashConfig.bRestoreChargesOnVerticalWallRun)
+		ChargeRestoreMovementModeMask |= MovementComponent->GetMovementModeMask(UMMovementMode_VerticalWallRun::StaticClass());
+}
+
+void UMMovementMode_Dash::ActivateCooldown()
+{
 	RuntimeData.CooldownTimer.Reset();
 }
 
+bool UMMovementMode_Dash::AllowsMovementSleep() const
+{
+	// Charges are reset to initial amount in Tick
+	const bool bCanRestoreCharges = DashConfig.bRestoreChargesOnGround || ChargeRestoreMovementModeMask != 0;
+	const bool bRestoringCharges = DashConfig.bEnableDashCharges && bCanRestoreCharges
+		&& RuntimeData.ChargesLeft != DashConfig.ChargeAmountInitial;
+	return Super::AllowsMovementSleep() && RuntimeData.CooldownTimer.IsCompleted() && !bRestoringCharges;
+}
+
 bool UMMovementMode_Dash::IsMovingOnGround_Implementation()
 {
 	return false;
@@ -227,8 +262,9 @@ void UMMovementMode_Dash::UseDashCharge(bool bPlayUIAnimation)
 void UMMovementMode_Dash::OnDashInput(const FInputActionInstance& Instance)
 {
 	RuntimeData.bWantsToDash = true;
+	WakeActivationCheck(EMMovementModeWakeCondition::InputTriggered);
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 1, FColor::Green, TEXT("Dash input triggered"));
 	}
@@ -289,7 +325,7 @@ void UMMovementMode_Dash::DealDamage(const FVector& LocationOld, const FVector&
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(CharacterOwner);
 
-	GetWorld()->SweepMultiByChannel(Hits, LocationOld, LocationNew, FQuat::Identity, ECC_WorldStatic, CollisionShape, QueryParams);
+	DashConfig.DamageQueryConfig.SweepMulti(GetWorld(), Hits, LocationOld, LocationNew, FQuat::Identity, CollisionShape, QueryParams);
 	for (const FHitResult& Hit : Hits)
 	{
 		UGameplayStatics::ApplyDamage(Hit.GetActor(), DashConfig.DamageAmount, CharacterOwner->GetController(),
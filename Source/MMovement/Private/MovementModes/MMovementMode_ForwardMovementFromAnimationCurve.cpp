@@ -31,8 +31,8 @@ void UMAnimNotifyState_ForwardMovementMode::NotifyBegin(USkeletalMeshComponent*
 		return;
 	}
 
-	UMMovementMode_ForwardMovementFromAnimationCurve* MovementMode = Cast<UMMovementMode_ForwardMovementFromAnimationCurve>(
-		CharacterMovementComponent->GetCustomMovementModeInstance(UMMovementMode_ForwardMovementFromAnimationCurve::StaticClass()));
+	UMMovementMode_ForwardMovementFromAnimationCurve* MovementMode =
+		CharacterMovementComponent->GetMode<UMMovementMode_ForwardMovementFromAnimationCurve>();
 	if (!ensure(IsValid(MovementMode)))
 	{
 		return;
@@ -66,8 +66,8 @@ void UMAnimNotifyState_ForwardMovementMode::NotifyEnd(USkeletalMeshComponent* Me
 		return;
 	}
 
-	UMMovementMode_ForwardMovementFromAnimationCurve* MovementMode = Cast<UMMovementMode_ForwardMovementFromAnimationCurve>(
-		CharacterMovementComponent->GetCustomMovementModeInstance(UMMovementMode_ForwardMovementFromAnimationCurve::StaticClass()));
+	UMMovementMode_ForwardMovementFromAnimationCurve* MovementMode =
+		CharacterMovementComponent->GetMode<UMMovementMode_ForwardMovementFromAnimationCurve>();
 	if (!ensure(IsValid(MovementMode)))
 	{
 		return;
@@ -81,6 +81,12 @@ void UMAnimNotifyState_ForwardMovementMode::NotifyEnd(USkeletalMeshComponent* Me
 	MovementMode->FinishAnimationMovement();
 }
 
+UMMovementMode_ForwardMovementFromAnimationCurve::UMMovementMode_ForwardMovementFromAnimationCurve()
+{
+	// Started only from StartAnimationMovement
+	WakeConditions = static_cast<int32>(EMMovementModeWakeCondition::InputTriggered);
+}
+
 void UMMovementMode_ForwardMovementFromAnimationCurve::Initialize_Implementation()
 {
 	Super::Initialize_Implementation();
@@ -91,11 +97,11 @@ void UMMovementMode_ForwardMovementFromAnimationCurve::Tick_Implementation(float
 	Super::Tick_Implementation(DeltaTime);
 }
 
-bool UMMovementMode_ForwardMovementFromAnimationCurve::CanStart_Implementation(FString& OutFailReason)
+bool UMMovementMode_ForwardMovementFromAnimationCurve::CanStart_Implementation(FMMovementMode_FailReason& OutFailReason)
 {
 	if (!RuntimeData.bWantsToStart)
 	{
-		OutFailReason = TEXT("Not triggered by input");
+		OutFailReason = EMMovementMode_FailReasonCode::NotTriggeredByInput;
 		return false;
 	}
 
@@ -204,6 +210,8 @@ void UMMovementMode_ForwardMovementFromAnimationCurve::StartAnimationMovement(co
 {
 	RuntimeData.bWantsToStart = true;
 	RuntimeData.DistanceMax = DistanceMax;
+
+	WakeActivationCheck(EMMovementModeWakeCondition::InputTriggered);
 }
 
 void UMMovementMode_ForwardMovementFromAnimationCurve::FinishAnimationMovement()
@@ -7,15 +7,32 @@
 #include "MMath.h"
 #include "MCharacterMovementComponent.h"
 #include "MMovementTypes.h"
+#include "MTraversalIndexSubsystem.h"
 #include "GameFramework/Character.h"
 #include "Kismet/KismetStringLibrary.h"
 
+UMMovementMode_Slide::UMMovementMode_Slide()
+{
+	// Slide can only start while slide input is held
+	WakeConditions = static_cast<int32>(EMMovementModeWakeCondition::InputTriggered | EMMovementModeWakeCondition::TimerExpired);
+}
+
 void UMMovementMode_Slide::Initialize_Implementation()
 {
 	Super::Initialize_Implementation();
 
 	TraceQueryParams.AddIgnoredActor(CharacterOwner);
 
+	MovementComponent->RegisterGroundProbeDistance(SlideConfig.SlideSurfaceDetectionMaxTraceDistance);
+
+	SlideSurfaceFilter.Compile(SurfaceSubsystem, SlideConfig.SlideSurfaceDetectionRequirementTag,
+	                           SlideConfig.SlideSurfaceDetectionExclusionTags);
+	SlopeSurfaceFilter.Compile(SurfaceSubsystem, SlideConfig.SlopeSurfaceDetectionRequirementTag,
+	                           SlideConfig.SlopeSurfaceDetectionExclusionTags);
+
+	if (SlideConfig.bUseTraversalIndex)
+		RegisterTraversalIndexSurfaceFilter(SlideSurfaceFilter);
+
 	RuntimeData.NoDecelerationOnEvenSurfaceTimer = FMManualTimer(SlideConfig.NoDecelerationOnEvenSurfaceDuration);
 	RuntimeData.NoDecelerationOnEvenSurfaceTimer.Complete();
 
@@ -37,9 +54,13 @@ void UMMovementMode_Slide::Tick_Implementation(float DeltaTime)
 {
 	Super::Tick_Implementation(DeltaTime);
 
-	RuntimeData.CooldownTimer.Tick(DeltaTime);
+	TickTimerWithActivationWake(RuntimeData.CooldownTimer, DeltaTime);
 	RuntimeData.NoDecelerationOnEvenSurfaceTimer.Tick(DeltaTime);
 
+	// Keep evaluating CanStart while input is held, other start conditions (surface, falling) can change meanwhile
+	if (RuntimeData.bInputHeld)
+		WakeActivationCheck(EMMovementModeWakeCondition::InputTriggered);
+
 	if (MovementComponent->IsFalling())
 	{
 		RuntimeData.FallingVelocitySaved = MovementComponent->Velocity;
@@ -49,7 +70,7 @@ void UMMovementMode_Slide::Tick_Implementation(float DeltaTime)
 		RuntimeData.bAwaitsInputUp = false;
 	}
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		if (!RuntimeData.CooldownTimer.IsCompleted())
 		{
@@ -59,23 +80,23 @@ void UMMovementMode_Slide::Tick_Implementation(float DeltaTime)
 	}
 }
 
-bool UMMovementMode_Slide::CanStart_Implementation(FString& OutFailReason)
+bool UMMovementMode_Slide::CanStart_Implementation(FMMovementMode_FailReason& OutFailReason)
 {
 	if (!RuntimeData.CooldownTimer.IsCompleted())
 	{
-		OutFailReason = TEXT("Cooldown");
+		OutFailReason = EMMovementMode_FailReasonCode::Cooldown;
 		return false;
 	}
 
 	if (!RuntimeData.bInputHeld)
 	{
-		OutFailReason = TEXT("Input not held");
+		OutFailReason = EMMovementMode_FailReasonCode::InputNotHeld;
 		return false;
 	}
 
 	if (RuntimeData.bAwaitsInputUp)
 	{
-		OutFailReason = TEXT("Awaits input up");
+		OutFailReason = EMMovementMode_FailReasonCode::AwaitsInputUp;
 		return false;
 	}
 
@@ -83,21 +104,21 @@ bool UMMovementMode_Slide::CanStart_Implementation(FString& OutFailReason)
 	if (SlideConfig.PlayerDesiredDirectionType == EMMovementMode_SlidePlayerDesiredDirectionType::MovementInputDirection
 		&& MovementComponent->Velocity.Size() <= 0)
 	{
-		OutFailReason = TEXT("Slide direction can't be determined from movement input");
+		OutFailReason = EMMovementMode_FailReasonCode::SlideDirectionUndetermined;
 		return false;
 	}
 
 	FMMovementMode_SlideSurfaceData SurfaceData = CalculateSlideSurfaceDataForCurrentLocation();
 	if (!SurfaceData.bValid)
 	{
-		OutFailReason = TEXT("Surface is not valid for slide");
+		OutFailReason = EMMovementMode_FailReasonCode::SurfaceInvalid;
 		return false;
 	}
 
 	// Is walking or is falling and can go from falling to sliding
 	if (!(MovementComponent->IsWalking() || CanStartSlideFromFalling(SurfaceData)))
 	{
-		OutFailReason = TEXT("Can't start slide from falling");
+		OutFailReason = EMMovementMode_FailReasonCode::CannotStartFromFalling;
 		return false;
 	}
 
@@ -134,7 +155,7 @@ void UMMovementMode_Slide::Phys_Implementation(float DeltaTime, int32 Iterations
 	{
 		const FVector JumpOffVector = GetJumpOffVector();
 
-		if (CVarShowMovementDebugs.GetValueOnGameThread())
+		if (ShouldShowMovementDebugs())
 		{
 			DrawDebugLine(GetWorld(), UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentLocation() + JumpOffVector,
 			              FColor::Black, false, 10, 5, 3);
@@ -159,7 +180,7 @@ void UMMovementMode_Slide::Phys_Implementation(float DeltaTime, int32 Iterations
 		MovementComponent->SetMovementMode(MOVE_Falling);
 		MovementComponent->StartNewPhysics(DeltaTime, Iterations);
 
-		if (CVarShowMovementDebugs.GetValueOnGameThread())
+		if (ShouldShowMovementDebugs())
 			GEngine->AddOnScreenDebugMessage(-1, 1, FColor::Red,TEXT("Slide end: Out of sliding surface"));
 	}
 
@@ -169,7 +190,7 @@ void UMMovementMode_Slide::Phys_Implementation(float DeltaTime, int32 Iterations
 		MovementComponent->SetMovementMode(MOVE_Walking);
 		MovementComponent->StartNewPhysics(DeltaTime, Iterations);
 
-		if (CVarShowMovementDebugs.GetValueOnGameThread())
+		if (ShouldShowMovementDebugs())
 			GEngine->AddOnScreenDebugMessage(-1, 1, FColor::Red,TEXT("Slide end: Input not held"));
 	}
 
@@ -180,7 +201,7 @@ void UMMovementMode_Slide::Phys_Implementation(float DeltaTime, int32 Iterations
 		MovementComponent->SetMovementMode(MOVE_Walking);
 		MovementComponent->StartNewPhysics(DeltaTime, Iterations);
 
-		if (CVarShowMovementDebugs.GetValueOnGameThread())
+		if (ShouldShowMovementDebugs())
 			GEngine->AddOnScreenDebugMessage(-1, 1, FColor::Red,TEXT("Slide end: Not sufficient speed"));
 	}
 
@@ -243,6 +264,7 @@ void UMMovementMode_Slide::Phys_Implementation(float DeltaTime, int32 Iterations
 	MovementComponent->SetAcceleration(SlideDirectionRotatedToTarget * AccelerationNew);
 
 	// Move along surface
+	// Snap stays a separate step, surface below the slide changes along the move (slope edges, ramps), so it's queried at the new location
 	const FVector LocationDelta = MovementComponent->Velocity * DeltaTime;
 
 	FHitResult Hit(1.f);
@@ -265,10 +287,10 @@ void UMMovementMode_Slide::Phys_Implementation(float DeltaTime, int32 Iterations
 		                                bSweep);
 	}
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		// Show slope info
-		if (SurfaceDataNew.bValid && SurfaceDataNew.bSlope)
+		if (SurfaceDataNew.IsSlope())
 		{
 			FString SlopeDebugStr = TEXT("Slope ");
 			if (bMovingInDownwardSlopeDirection)
@@ -288,7 +310,7 @@ void UMMovementMode_Slide::End_Implementation()
 {
 	Super::End_Implementation();
 
-	RuntimeData.CooldownTimer.Reset();
+	ActivateCooldown();
 
 	CharacterOwner->UnCrouch();
 }
@@ -308,15 +330,28 @@ bool UMMovementMode_Slide::IsMovingOnSurface_Implementation()
 	return true;
 }
 
+void UMMovementMode_Slide::ActivateCooldown()
+{
+	RuntimeData.CooldownTimer.Reset();
+}
+
+bool UMMovementMode_Slide::AllowsMovementSleep() const
+{
+	return Super::AllowsMovementSleep() && RuntimeData.CooldownTimer.IsCompleted();
+}
+
 void UMMovementMode_Slide::OnSlideInput(const FInputActionInstance& Instance)
 {
 	bool bInputValue = Instance.GetValue().Get<bool>();
 	RuntimeData.bInputHeld = bInputValue;
 
+	if (bInputValue)
+		WakeActivationCheck(EMMovementModeWakeCondition::InputTriggered);
+
 	if (RuntimeData.bAwaitsInputUp && !bInputValue)
 		RuntimeData.bAwaitsInputUp = false;
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 1, FColor::Green,
 		                                 FString::Printf(
@@ -369,13 +404,23 @@ FVector UMMovementMode_Slide::GetJumpOffVector() const
 
 FMMovementMode_SlideSurfaceData UMMovementMode_Slide::CalculateSlideSurfaceDataForCurrentLocation() const
 {
-	FVector TraceStart = UpdatedComponent->GetComponentLocation();
-	FVector TraceEnd = UpdatedComponent->GetComponentLocation()
-		+ FVector::DownVector * SlideConfig.SlideSurfaceDetectionMaxTraceDistance;
-
 	FHitResult GroundTraceHitResult;
-	bool bGroundHit = GetWorld()->LineTraceSingleByChannel(GroundTraceHitResult, TraceStart, TraceEnd,
-	                                                       ECC_WorldStatic, TraceQueryParams);
+	bool bGroundHit = false;
+
+	bool bIndexQueried = false;
+	if (SlideConfig.bUseTraversalIndex && IsValid(TraversalIndexSubsystem))
+	{
+		const FVector TraceStart = UpdatedComponent->GetComponentLocation();
+		const FVector TraceEnd = TraceStart + FVector::DownVector * SlideConfig.SlideSurfaceDetectionMaxTraceDistance;
+		bIndexQueried = TraversalIndexSubsystem->LineTrace(TraceStart, TraceEnd, SlideSurfaceFilter, bGroundHit, GroundTraceHitResult);
+	}
+
+	if (!bIndexQueried)
+	{
+		const FMMovementGroundProbeResult& GroundProbe = MovementComponent->ProbeGround(SlideConfig.SlideSurfaceDetectionMaxTraceDistance);
+		bGroundHit = GroundProbe.IsGroundWithin(SlideConfig.SlideSurfaceDetectionMaxTraceDistance);
+		GroundTraceHitResult = GroundProbe.Hit;
+	}
 
 	if (!bGroundHit || !IsSlidableSurface(GroundTraceHitResult.GetComponent()))
 	{
@@ -444,23 +489,8 @@ FVector UMMovementMode_Slide::CalculateInitialSlideVelocity() const
 
 bool UMMovementMode_Slide::IsSlidableSurface(UPrimitiveComponent* PrimitiveComponent) const
 {
-	// Check if surface has required tag to be considered slidable surface
-	if (!SlideConfig.SlideSurfaceDetectionRequirementTag.IsNone()
-		&& !PrimitiveComponent->ComponentHasTag(SlideConfig.SlideSurfaceDetectionRequirementTag))
-	{
-		return false;
-	}
-
-	// Exclude surface from being considered a slidable surface if it has any of the specified exclusion tags
-	for (const FName& SlideSurfaceExclusionTag : SlideConfig.SlideSurfaceDetectionExclusionTags)
-	{
-		if (PrimitiveComponent->ComponentHasTag(SlideSurfaceExclusionTag))
-		{
-			return false;
-		}
-	}
-
-	return true;
+	// Surface needs required category and none of the exclusion categories to be considered slidable surface
+	return ClassifySurface(SlideSurfaceFilter, PrimitiveComponent) == EMMovementSurfaceFilterResult::Passed;
 }
 
 bool UMMovementMode_Slide::IsSlope(const FHitResult& HitResult) const
@@ -472,21 +502,6 @@ bool UMMovementMode_Slide::IsSlope(const FHitResult& HitResult) const
 		return false;
 	}
 
-	// Check if surface has required tag to be considered a slope
-	if (!SlideConfig.SlopeSurfaceDetectionRequirementTag.IsNone()
-		&& !HitResult.GetComponent()->ComponentHasTag(SlideConfig.SlopeSurfaceDetectionRequirementTag))
-	{
-		return false;
-	}
-
-	// Exclude surface from being considered a slope if it has any of the specified exclusion tags
-	for (const FName& SlopeExclusionTag : SlideConfig.SlopeSurfaceDetectionExclusionTags)
-	{
-		if (HitResult.GetComponent()->ComponentHasTag(SlopeExclusionTag))
-		{
-			return false;
-		}
-	}
-
-	return true;
+	// Surface needs required category and none of the exclusion categories to be considered a slope
+	return ClassifySurface(SlopeSurfaceFilter, HitResult.GetComponent()) == EMMovementSurfaceFilterResult::Passed;
 }
@@ -5,7 +5,9 @@
 
 #include "MMath.h"
 #include "MCharacterMovementComponent.h"
+#include "MMovementDiagnostics.h"
 #include "MMovementTypes.h"
+#include "MTraversalIndexSubsystem.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/Character.h"
 #include "MovementModes/MMovementMode_WallRun.h"
@@ -13,6 +15,15 @@
 UMMovementMode_VerticalWallRun::UMMovementMode_VerticalWallRun()
 {
 	MovementModeName = TEXT("Vertical Wall Run");
+
+	// Vertical wall run can only start while falling next to a wall, CanStart is evaluated when sensed wall changes (see Tick)
+	WakeConditions = static_cast<int32>(EMMovementModeWakeCondition::SurfaceSensorChanged);
+
+	TransitionConfig.CannotInterrupt.Add(UMMovementMode_WallRun::StaticClass());
+	TransitionConfig.CannotInterrupt.Add(UMMovementMode_VerticalWallRun::StaticClass());
+
+	// Delay wall run after vertical wall run
+	TransitionConfig.ActivateCooldownOnEnd.Add(UMMovementMode_WallRun::StaticClass());
 }
 
 void UMMovementMode_VerticalWallRun::Initialize_Implementation()
@@ -21,6 +32,12 @@ void UMMovementMode_VerticalWallRun::Initialize_Implementation()
 
 	WallDetectionQueryParams.AddIgnoredActor(CharacterOwner);
 
+	MovementComponent->RegisterGroundProbeDistance(ConfigData.MinDistanceFromGround);
+
+	SurfaceFilter.Compile(SurfaceSubsystem, ConfigData.SurfaceRequirementTag, ConfigData.SurfaceExclusionTags);
+	if (ConfigData.bUseTraversalIndex)
+		RegisterTraversalIndexSurfaceFilter(SurfaceFilter);
+
 	RuntimeData.CooldownTimer = FMManualTimer(ConfigData.CooldownTime);
 }
 
@@ -28,11 +45,15 @@ void UMMovementMode_VerticalWallRun::Tick_Implementation(float DeltaTime)
 {
 	Super::Tick_Implementation(DeltaTime);
 
-	SweepAndCalculateSurfaceInfo();
+	SweepAndCalculateSurfaceInfo(DeltaTime);
 
-	RuntimeData.CooldownTimer.Tick(DeltaTime);
+	TickTimerWithActivationWake(RuntimeData.CooldownTimer, DeltaTime);
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	// Height and speed checked by CanStart change every frame, keep evaluating it while falling next to a wall
+	if (RuntimeData.SurfaceInfo.bValid && MovementComponent->IsFalling())
+		WakeActivationCheck(EMMovementModeWakeCondition::SurfaceSensorChanged);
+
+	if (ShouldShowMovementDebugs())
 	{
 		if (!RuntimeData.CooldownTimer.IsCompleted())
 		{
@@ -40,48 +61,38 @@ void UMMovementMode_VerticalWallRun::Tick_Implementation(float DeltaTime)
 			                                 FString::Printf(
 				                                 TEXT("Vertical Wall Run Cooldown: %.2f"), RuntimeData.CooldownTimer.GetTimeLeft()));
 		}
+
+		FMTraversalIndexLedgeHit LedgeAbove;
+		if (GetLedgeAbove(LedgeAbove))
+		{
+			DrawDebugLine(GetWorld(), LedgeAbove.Location, LedgeAbove.Location + LedgeAbove.WallNormal * 50, FColor::Yellow, false, 0);
+		}
 	}
 }
 
-bool UMMovementMode_VerticalWallRun::CanStart_Implementation(FString& OutFailReason)
+bool UMMovementMode_VerticalWallRun::CanStart_Implementation(FMMovementMode_FailReason& OutFailReason)
 {
 	if (!MovementComponent->IsFalling())
 	{
-		OutFailReason = TEXT("Character is not falling");
+		OutFailReason = EMMovementMode_FailReasonCode::NotFalling;
 		return false;
 	}
 
-	UMMovementMode_Base* ActiveCustomMovementMode = MovementComponent->GetActiveCustomMovementModeInstance();
-	if (IsValid(ActiveCustomMovementMode))
-	{
-		if (ActiveCustomMovementMode->IsA<UMMovementMode_WallRun>())
-		{
-			OutFailReason = TEXT("Wall run is active");
-			return false;
-		}
-
-		if (ActiveCustomMovementMode->IsA<UMMovementMode_VerticalWallRun>())
-		{
-			OutFailReason = TEXT("Vertical Wall run is active");
-			return false;
-		}
-	}
-
 	if (!RuntimeData.CooldownTimer.IsCompleted())
 	{
-		OutFailReason = TEXT("Cooldown");
+		OutFailReason = EMMovementMode_FailReasonCode::Cooldown;
 		return false;
 	}
 
 	if (!RuntimeData.SurfaceInfo.bValid)
 	{
-		OutFailReason = TEXT("Surface is not valid for vertical wall run");
+		OutFailReason = EMMovementMode_FailReasonCode::SurfaceInvalid;
 		return false;
 	}
 
 	if (!IsHighEnoughFromGround())
 	{
-		OutFailReason = TEXT("Too close to ground");
+		OutFailReason = EMMovementMode_FailReasonCode::TooCloseToGround;
 		return false;
 	}
 
@@ -95,10 +106,9 @@ bool UMMovementMode_VerticalWallRun::CanStart_Implementation(FString& OutFailRea
 			MMath::AngleBetweenVectorsDeg(PeakHorizontalVelocity, -RuntimeData.SurfaceInfo.Normal);
 		if (AngleBetweenSurfaceNormalAndHorizontalVelocity > ConfigData.HorizontalVelocityToSurfaceNormalAngleMax)
 		{
-			OutFailReason = FString::Printf(
-				TEXT("Angle between surface normal and horizontal velocity too high (angle: %.2f, max: %.2f)"),
-				AngleBetweenSurfaceNormalAndHorizontalVelocity, ConfigData.HorizontalVelocityToSurfaceNormalAngleMax);
-
+			OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::SurfaceToVelocityAngleTooHigh,
+			                                          AngleBetweenSurfaceNormalAndHorizontalVelocity,
+			                                          ConfigData.HorizontalVelocityToSurfaceNormalAngleMax);
 			return false;
 		}
 	}
@@ -108,28 +118,25 @@ bool UMMovementMode_VerticalWallRun::CanStart_Implementation(FString& OutFailRea
 		                              -MMath::ToHorizontalDirection(RuntimeData.SurfaceInfo.Normal));
 	if (AngleBetweenSurfaceNormalAndCharacterNormal > ConfigData.MaxAngleBetweenSurfaceNormalAndCharacterForwardToStart)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Angle between surface normal and character forward too high (angle: %.2f, max: %.2f)"),
-			AngleBetweenSurfaceNormalAndCharacterNormal, ConfigData.MaxAngleBetweenSurfaceNormalAndCharacterForwardToStart);
-
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::SurfaceToForwardAngleTooHigh,
+		                                          AngleBetweenSurfaceNormalAndCharacterNormal,
+		                                          ConfigData.MaxAngleBetweenSurfaceNormalAndCharacterForwardToStart);
 		return false;
 	}
 
 	const float HorizontalSpeed = PeakHorizontalVelocity.Size2D();
 	if (HorizontalSpeed < ConfigData.MinHorizontalSpeedToStart)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Horizontal speed too low (hspeed: %.2f, min: %.2f)"), HorizontalSpeed, ConfigData.MinHorizontalSpeedToStart);
-
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::HorizontalSpeedTooLow,
+		                                          HorizontalSpeed, ConfigData.MinHorizontalSpeedToStart);
 		return false;
 	}
 
 	const float VerticalSpeed = MovementComponent->Velocity.Z;
 	if (!ConfigData.bEnableSlideDown && VerticalSpeed < ConfigData.MinVerticalSpeedToStart)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Vertical speed too low (vspeed: %.2f, min: %.2f)"), VerticalSpeed, ConfigData.MinVerticalSpeedToStart);
-
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::VerticalSpeedTooLow,
+		                                          VerticalSpeed, ConfigData.MinVerticalSpeedToStart);
 		return false;
 	}
 
@@ -177,7 +184,7 @@ void UMMovementMode_VerticalWallRun::Phys_Implementation(float DeltaTime, int32
 	{
 		const FVector JumpOffVelocity = GetJumpOffVelocity();
 
-		RuntimeData.CooldownTimer.Reset();
+		ActivateCooldown();
 
 		// Override character rotation on jump of
 		if (ConfigData.bJumpOffRotateCharacterToVelocity)
@@ -187,7 +194,7 @@ void UMMovementMode_VerticalWallRun::Phys_Implementation(float DeltaTime, int32
 		}
 
 		MovementComponent->AddControlledLaunchFromAsset(JumpOffVelocity, ConfigData.JumpOffControlledLaunchAsset, this);
-		UE_VLOG_ARROW(CharacterOwner, LogMMovement, Display, UpdatedComponent->GetComponentLocation(),
+		MMOVEMENT_VLOG_ARROW(CharacterOwner, LogMMovement, Display, UpdatedComponent->GetComponentLocation(),
 		              UpdatedComponent->GetComponentLocation() + JumpOffVelocity, FColor::Blue, TEXT("Vertical Wall Run jump off"));
 
 		MovementComponent->OnJumpedDelegate.Broadcast();
@@ -227,44 +234,29 @@ void UMMovementMode_VerticalWallRun::Phys_Implementation(float DeltaTime, int32
 	MovementComponent->Velocity = Velocity;
 	MovementComponent->SetAcceleration(-MovementDirection * ConfigData.Deceleration);
 
-	// Move along surface
+	// Move along surface and snap to surface we are running on
 	const FVector LocationDelta = MovementComponent->Velocity * DeltaTime;
 
 	FHitResult Hit(1.f);
-
-	MovementComponent->SafeMoveUpdatedComponent(LocationDelta, UpdatedComponent->GetComponentQuat(), true, Hit);
-
-	if (Hit.Time < 1.f)
+	MovementComponent->SafeMoveUpdatedComponentWithSnap(LocationDelta, DeltaTime, [this, DeltaTime](const FVector& Location)
 	{
-		MovementComponent->HandleImpact(Hit, DeltaTime, LocationDelta);
-		MovementComponent->SlideAlongSurface(LocationDelta, (1.0f - Hit.Time), Hit.Normal, Hit, true);
-	}
-
-	// Snap to surface we are running on
-	const FVector ToSurfaceNormal = FVector::VectorPlaneProject(-GetSurfaceNormal(), FVector::UpVector).GetSafeNormal();
-	const FVector Location = UpdatedComponent->GetComponentLocation();
-	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+		return CalculateWallSnapDelta(Location, DeltaTime);
+	}, Hit);
 
-	const FVector Difference = (GetSnapLocation() - Location).ProjectOnTo(ToSurfaceNormal);
-	const FVector Offset = -GetSurfaceNormal() * (Difference.Length() - ConfigData.OffsetFromWall);
-
-	constexpr bool bSweep = true;
-	UpdatedComponent->MoveComponent(Offset * ConfigData.WallOffsetSnapSpeed * DeltaTime, Rotation, bSweep);
-
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		DrawDebugPoint(GetWorld(), UpdatedComponent->GetComponentLocation(), 5, FColor::White, false, 5, 5);
 	}
 }
 
-void UMMovementMode_VerticalWallRun::End_Implementation()
+void UMMovementMode_VerticalWallRun::ActivateCooldown()
 {
-	Super::End_Implementation();
+	RuntimeData.CooldownTimer.Reset();
+}
 
-	// Delay wall run after vertical wall run
-	if (UMMovementMode_WallRun* WallRun =
-		Cast<UMMovementMode_WallRun>(MovementComponent->GetCustomMovementModeInstance(UMMovementMode_WallRun::StaticClass())))
-		WallRun->ActivateCooldown();
+bool UMMovementMode_VerticalWallRun::AllowsMovementSleep() const
+{
+	return Super::AllowsMovementSleep() && RuntimeData.CooldownTimer.IsCompleted();
 }
 
 bool UMMovementMode_VerticalWallRun::IsMovingOnGround_Implementation()
@@ -292,6 +284,12 @@ void UMMovementMode_VerticalWallRun::AddVisualLoggerInfo(struct FVisualLogEntry*
 				TEXT("%s"), RuntimeData.bSlideDownInProgress ? TEXT("Descending") : TEXT("Ascending"));
 			MovementModeCategory.Add(TEXT("Slide Down State"), SlideDownStateStr);
 		}
+
+		FMTraversalIndexLedgeHit LedgeAbove;
+		if (GetLedgeAbove(LedgeAbove))
+		{
+			MovementModeCategory.Add(TEXT("Ledge Above"), FString::Printf(TEXT("%.2f"), LedgeAbove.Height));
+		}
 	}
 
 	// Log info about calculated surface
@@ -303,11 +301,7 @@ void UMMovementMode_VerticalWallRun::AddVisualLoggerInfo(struct FVisualLogEntry*
 	{
 		auto& SurfaceHitInfo = RuntimeData.SurfaceInfo.SurfaceHitInfoArray[i];
 
-		FString SurfaceHitValidStr = SurfaceHitInfo.bValid ? "Valid" : "Invalid";
-		if (!SurfaceHitInfo.bValid)
-		{
-			SurfaceHitValidStr += FString::Printf(TEXT(":%s"), *SurfaceHitInfo.InvalidReason);
-		}
+		const FString SurfaceHitValidStr = SurfaceHitInfo.Validation.ToString();
 
 		MovementModeCategory.Add(
 			FString::Printf(TEXT("Surf. Hit Valid.(%d)"), i),
@@ -315,7 +309,7 @@ void UMMovementMode_VerticalWallRun::AddVisualLoggerInfo(struct FVisualLogEntry*
 	}
 }
 
-void UMMovementMode_VerticalWallRun::SweepAndCalculateSurfaceInfo()
+void UMMovementMode_VerticalWallRun::SweepAndCalculateSurfaceInfo(const float DeltaTime)
 {
 	auto CapsuleComponent = CharacterOwner->GetCapsuleComponent();
 	const FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(
@@ -329,13 +323,46 @@ void UMMovementMode_VerticalWallRun::SweepAndCalculateSurfaceInfo()
 	const FVector End = Start + UpdatedComponent->GetForwardVector() * 100;
 
 	TArray<FHitResult> Hits;
-	GetWorld()->SweepMultiByChannel(Hits, Start, End, FQuat::Identity,
-	                                ECC_WorldStatic, CollisionShape, WallDetectionQueryParams);
+	if (ConfigData.bUseTraversalIndex && IsValid(TraversalIndexSubsystem)
+		&& TraversalIndexSubsystem->QueryCapsule(Start, End, CollisionShape.GetCapsuleRadius(), CollisionShape.GetCapsuleHalfHeight(),
+		                                         SurfaceFilter, Hits))
+	{
+		// Any async sweep in flight would be stale by the time index can't answer
+		SurfaceSensor.Reset();
+	}
+	else if (ConfigData.SurfaceSensingMode == EMMovementSurfaceSensingMode::Async)
+	{
+		if (!SurfaceSensor.ConsumeAsyncSweep(GetWorld(), Start, ConfigData.AsyncSensingMaxPredictionError, Hits))
+		{
+			FMMovementSurfaceSensor::SweepSync(GetWorld(), Start, End, ConfigData.SurfaceQueryConfig, CollisionShape,
+			                                   WallDetectionQueryParams, Hits);
+		}
+
+		// Request next frame's sweep from where character is expected to be by then
+		const FVector PredictedOffset = MovementComponent->Velocity * DeltaTime;
+		SurfaceSensor.RequestAsyncSweep(GetWorld(), Start + PredictedOffset, End + PredictedOffset,
+		                                ConfigData.SurfaceQueryConfig, CollisionShape, WallDetectionQueryParams);
+	}
+	else
+	{
+		if (SurfaceSensor.HasPendingRequest())
+			SurfaceSensor.Reset();
+
+		FMMovementSurfaceSensor::SweepSync(GetWorld(), Start, End, ConfigData.SurfaceQueryConfig, CollisionShape,
+		                                   WallDetectionQueryParams, Hits);
+	}
 
 	RuntimeData.SurfaceInfoOld = RuntimeData.SurfaceInfo;
 	RuntimeData.SurfaceInfo = CalculateSurfaceInfo(Hits);
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	// Wall found, lost or replaced by another one is signaled for modes waking on SurfaceSensorChanged
+	if (RuntimeData.SurfaceInfo.bValid != RuntimeData.SurfaceInfoOld.bValid
+		|| RuntimeData.SurfaceInfo.PrimitiveComponent != RuntimeData.SurfaceInfoOld.PrimitiveComponent)
+	{
+		WakeActivationCheck(EMMovementModeWakeCondition::SurfaceSensorChanged);
+	}
+
+	if (ShouldShowMovementDebugs())
 	{
 		DrawDebugCapsule(GetWorld(), Start, CollisionShape.GetCapsuleHalfHeight(), CollisionShape.GetCapsuleRadius(),
 		                 FQuat::Identity, FColor::White);
@@ -348,50 +375,73 @@ FMCharacterMovement_VerticalWallRunSurfaceInfo UMMovementMode_VerticalWallRun::C
 	SurfaceInfoResult.SurfaceHitInfoArray.Init(FMCharacterMovement_VerticalWallRunSurfaceHitInfo(), Hits.Num());
 	TArray<FMCharacterMovement_VerticalWallRunSurfaceHitInfo> SurfaceHitInfoArrayValid;
 
+	// Names of excluded categories are resolved only when somebody looks at them
+	const bool bRecordDiagnostics = ShouldRecordMovementDiagnostics();
+
+	// Sweep can return several hits on the same component, only the first valid one is used
+	// Component is added only after its hit passes validation, so a failing hit doesn't discard later hits on it
+	TArray<const UPrimitiveComponent*, TInlineAllocator<8>> ValidatedComponents;
+
 	// Filter hits to have only correct wall hits
 	for (int i = 0; i < Hits.Num(); ++i)
 	{
 		const FHitResult& Hit = Hits[i];
 		FMCharacterMovement_VerticalWallRunSurfaceHitInfo& SurfaceHitInfo = SurfaceInfoResult.SurfaceHitInfoArray[i];
 
-		// Check if surface has wall runnable tag
-		if (!ConfigData.SurfaceRequirementTag.IsNone() && !Hit.GetComponent()->ComponentHasTag(ConfigData.SurfaceRequirementTag))
+		SurfaceHitInfo.Validation.Actor = Hit.GetActor();
+
+		if (ValidatedComponents.Contains(Hit.GetComponent()))
 		{
-			SurfaceHitInfo.InvalidReason = FString::Printf(
-				TEXT("Surface doesn't have required tag (tag required: %s)"), *ConfigData.SurfaceRequirementTag.ToString());
+			INC_DWORD_STAT(STAT_MMovement_SurfaceAssistQueriesSkipped);
+			SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::ComponentAlreadyValidated;
 
 			continue;
 		}
 
-		// Check if surface doesn't have any of specified exclusion tags
-		bool bExcludedFromTag = false;
-		for (const FName& ExclusionTag : ConfigData.SurfaceExclusionTags)
+		// Check if surface has wall runnable category and none of the exclusion categories
+		FName ExcludedCategory;
+		const EMMovementSurfaceFilterResult SurfaceFilterResult = ClassifySurface(SurfaceFilter, Hit.GetComponent(),
+		                                                                          bRecordDiagnostics ? &ExcludedCategory : nullptr);
+		if (SurfaceFilterResult == EMMovementSurfaceFilterResult::MissingRequiredCategory)
 		{
-			if (Hit.GetComponent()->ComponentHasTag(ExclusionTag))
-			{
-				bExcludedFromTag = true;
-				SurfaceHitInfo.InvalidReason = FString::Printf(
-					TEXT("Surface contains exclusion tag (exclusion tag: %s)"), *ExclusionTag.ToString());
+			SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::MissingRequiredCategory;
+			SurfaceHitInfo.Validation.Category = ConfigData.SurfaceRequirementTag;
 
-				break;
-			}
+			continue;
 		}
 
-		if (bExcludedFromTag)
+		if (SurfaceFilterResult == EMMovementSurfaceFilterResult::ExcludedCategory)
 		{
+			SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::ExcludedCategory;
+			SurfaceHitInfo.Validation.Category = ExcludedCategory;
+
 			continue;
 		}
 
-		// Sweep assist hit to get correct normal and check if wall is close enough
-		FHitResult AssistHit;
+		// Sweep assist hit against the hit component to get correct normal and check if wall is close enough
+		// Skipped when the sweep impact is already precise and within reach
+		constexpr float AssistSphereRadius = 6;
 		const FVector Start = UpdatedComponent->GetComponentLocation();
-		const FVector End = Start + MMath::FromToVectorNormalized(Start, Hit.ImpactPoint) * ConfigData.MaxDistanceFromWallToStart;
-		const FCollisionShape CollisionSphere = FCollisionShape::MakeSphere(6);
-		const bool bSurfaceHit = GetWorld()->SweepSingleByChannel(AssistHit, Start, End, FQuat::Identity,
-		                                                          ECC_WorldStatic, CollisionSphere, WallDetectionQueryParams);
+
+		FHitResult AssistHit = Hit;
+		bool bSurfaceHit = true;
+		if (!FMMovementSurfaceSensor::IsImpactPrecise(Hit)
+			|| FVector::Dist(Start, Hit.ImpactPoint) > ConfigData.MaxDistanceFromWallToStart + AssistSphereRadius)
+		{
+			INC_DWORD_STAT(STAT_MMovement_SurfaceAssistQueries);
+
+			const FVector End = Start + MMath::FromToVectorNormalized(Start, Hit.ImpactPoint) * ConfigData.MaxDistanceFromWallToStart;
+			const FCollisionShape CollisionSphere = FCollisionShape::MakeSphere(AssistSphereRadius);
+			bSurfaceHit = Hit.GetComponent()->SweepComponent(AssistHit, Start, End, FQuat::Identity, CollisionSphere);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_MMovement_SurfaceAssistQueriesSkipped);
+		}
+
 		if (!bSurfaceHit)
 		{
-			SurfaceHitInfo.InvalidReason = TEXT("Assist hit did not hit a surface");
+			SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::AssistQueryMissed;
 
 			continue;
 		}
@@ -402,18 +452,18 @@ FMCharacterMovement_VerticalWallRunSurfaceInfo UMMovementMode_VerticalWallRun::C
 			const float SurfaceAngle = MMath::SignedAngleBetweenVectorsDeg(FVector::UpVector, AssistHit.Normal);
 			if (SurfaceAngle <= ConfigData.MinSurfaceAngle)
 			{
-				SurfaceHitInfo.InvalidReason = FString::Printf(TEXT("Surface angle is too low (angle: %.2f, min: %.2f)"),
-				                                               SurfaceAngle,
-				                                               ConfigData.MinSurfaceAngle);
+				SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::SurfaceAngleTooLow;
+				SurfaceHitInfo.Validation.Value = SurfaceAngle;
+				SurfaceHitInfo.Validation.Limit = ConfigData.MinSurfaceAngle;
 
 				continue;
 			}
 
 			if (SurfaceAngle >= ConfigData.MaxSurfaceAngle)
 			{
-				SurfaceHitInfo.InvalidReason = FString::Printf(TEXT("Surface angle is too high (angle: %.2f, max: %.2f)"),
-				                                               SurfaceAngle,
-				                                               ConfigData.MaxSurfaceAngle);
+				SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::SurfaceAngleTooHigh;
+				SurfaceHitInfo.Validation.Value = SurfaceAngle;
+				SurfaceHitInfo.Validation.Limit = ConfigData.MaxSurfaceAngle;
 
 				continue;
 			}
@@ -424,9 +474,10 @@ FMCharacterMovement_VerticalWallRunSurfaceInfo UMMovementMode_VerticalWallRun::C
 			constexpr float SurfaceAngleMin = 30;
 			if (SurfaceAngle <= SurfaceAngleMin)
 			{
-				SurfaceHitInfo.InvalidReason = FString::Printf(TEXT("Surface angle is too low (mantle) (angle: %.2f, min: %.2f)"),
-				                                               SurfaceAngle,
-				                                               SurfaceAngleMin);
+				SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::SurfaceAngleTooLow;
+				SurfaceHitInfo.Validation.Value = SurfaceAngle;
+				SurfaceHitInfo.Validation.Limit = SurfaceAngleMin;
+				SurfaceHitInfo.Validation.bActiveAngleRange = true;
 
 				continue;
 			}
@@ -434,9 +485,10 @@ FMCharacterMovement_VerticalWallRunSurfaceInfo UMMovementMode_VerticalWallRun::C
 			constexpr float SurfaceAngleMax = 150;
 			if (SurfaceAngle >= SurfaceAngleMax)
 			{
-				SurfaceHitInfo.InvalidReason = FString::Printf(TEXT("Surface angle is too high (mantle) (angle: %.2f, max: %.2f)"),
-				                                               SurfaceAngle,
-				                                               SurfaceAngleMax);
+				SurfaceHitInfo.Validation.Result = EMMovementSurfaceValidationResult::SurfaceAngleTooHigh;
+				SurfaceHitInfo.Validation.Value = SurfaceAngle;
+				SurfaceHitInfo.Validation.Limit = SurfaceAngleMax;
+				SurfaceHitInfo.Validation.bActiveAngleRange = true;
 
 				continue;
 			}
@@ -446,9 +498,13 @@ FMCharacterMovement_VerticalWallRunSurfaceInfo UMMovementMode_VerticalWallRun::C
 		SurfaceHitInfo.SnapLocation = AssistHit.ImpactPoint;
 		SurfaceHitInfo.Normal = AssistHit.Normal;
 
+		ValidatedComponents.Add(Hit.GetComponent());
 		SurfaceHitInfoArrayValid.Add(SurfaceHitInfo);
 
-		if (CVarShowMovementDebugs.GetValueOnGameThread())
+		if (SurfaceInfoResult.PrimitiveComponent == nullptr)
+			SurfaceInfoResult.PrimitiveComponent = Hit.GetComponent();
+
+		if (ShouldShowMovementDebugs())
 			DrawDebugLine(GetWorld(), AssistHit.ImpactPoint, AssistHit.ImpactPoint + AssistHit.Normal * 50, FColor::Green, false, 5);
 	}
 
@@ -472,6 +528,29 @@ FMCharacterMovement_VerticalWallRunSurfaceInfo UMMovementMode_VerticalWallRun::C
 	return SurfaceInfoResult;
 }
 
+bool UMMovementMode_VerticalWallRun::FindLedgeAbove(const float MaxHeight, bool& bOutFound, FMTraversalIndexLedgeHit& OutLedge) const
+{
+	bOutFound = false;
+
+	if (!ConfigData.bUseTraversalIndex || !IsValid(TraversalIndexSubsystem))
+		return false;
+
+	// Ledge has to be within reach of the wall detection, measured from the capsule center
+	const float Radius = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() + ConfigData.OffsetFromWall;
+
+	return TraversalIndexSubsystem->FindLedgeAbove(UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetForwardVector(),
+	                                               Radius, MaxHeight, SurfaceFilter, bOutFound, OutLedge);
+}
+
+bool UMMovementMode_VerticalWallRun::GetLedgeAbove(FMTraversalIndexLedgeHit& OutLedge) const
+{
+	if (!IsMovementModeActive())
+		return false;
+
+	bool bFound;
+	return FindLedgeAbove(ConfigData.LedgeDetectionHeight, bFound, OutLedge) && bFound;
+}
+
 FVector UMMovementMode_VerticalWallRun::GetAscendingDirectionAlongSurface() const
 {
 	FVector DirectionAlongSurface = FVector::VectorPlaneProject(MovementComponent->Velocity, GetSurfaceNormal());
@@ -486,14 +565,7 @@ FVector UMMovementMode_VerticalWallRun::GetAscendingDirectionAlongSurface() cons
 bool UMMovementMode_VerticalWallRun::IsHighEnoughFromGround() const
 {
 	// Check if ground is far enough
-	FHitResult GroundTraceHitResult;
-	bool bGroundHit = GetWorld()->LineTraceSingleByChannel(GroundTraceHitResult,
-	                                                       UpdatedComponent->GetComponentLocation(),
-	                                                       UpdatedComponent->GetComponentLocation()
-	                                                       + FVector::DownVector * ConfigData.MinDistanceFromGround,
-	                                                       ECC_WorldStatic, WallDetectionQueryParams);
-
-	return !bGroundHit;
+	return !MovementComponent->ProbeGround(ConfigData.MinDistanceFromGround).IsGroundWithin(ConfigData.MinDistanceFromGround);
 }
 
 bool UMMovementMode_VerticalWallRun::CanContinue() const
@@ -516,6 +588,16 @@ FVector UMMovementMode_VerticalWallRun::GetSurfaceNormal() const
 	return RuntimeData.SurfaceInfo.Normal;
 }
 
+FVector UMMovementMode_VerticalWallRun::CalculateWallSnapDelta(const FVector& Location, const float DeltaTime) const
+{
+	const FVector ToSurfaceNormal = FVector::VectorPlaneProject(-GetSurfaceNormal(), FVector::UpVector).GetSafeNormal();
+
+	const FVector Difference = (GetSnapLocation() - Location).ProjectOnTo(ToSurfaceNormal);
+	const FVector Offset = -GetSurfaceNormal() * (Difference.Length() - ConfigData.OffsetFromWall);
+
+	return Offset * ConfigData.WallOffsetSnapSpeed * DeltaTime;
+}
+
 FVector UMMovementMode_VerticalWallRun::GetSnapLocation() const
 {
 	return RuntimeData.SurfaceInfo.SnapLocation;
@@ -5,14 +5,28 @@
 
 #include "MCharacterMovementComponent.h"
 #include "MMath.h"
+#include "MMovementDiagnostics.h"
 #include "MMovementTypes.h"
+#include "MTraversalFieldSubsystem.h"
+#include "MTraversalIndexSubsystem.h"
+#include "MWallRunRailComponent.h"
 #include "MString.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/Character.h"
+#include "Misc/ScopeExit.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Run Surface Revalidations"), STAT_MMovement_WallRunSurfaceRevalidations, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Run Full Surface Sweeps"), STAT_MMovement_WallRunFullSurfaceSweeps, STATGROUP_MMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wall Run Traversal Field Lookups"), STAT_MMovement_WallRunTraversalFieldLookups, STATGROUP_MMovement);
 
 UMMovementMode_WallRun::UMMovementMode_WallRun()
 {
 	MovementModeName = TEXT("Wall Run");
+
+	// Wall run can only start while falling next to a wall, CanStart is evaluated when sensed wall changes (see Tick)
+	WakeConditions = static_cast<int32>(EMMovementModeWakeCondition::SurfaceSensorChanged);
+
+	TransitionConfig.CannotInterrupt.Add(UMMovementMode_WallRun::StaticClass());
 }
 
 void UMMovementMode_WallRun::Initialize_Implementation()
@@ -22,6 +36,17 @@ void UMMovementMode_WallRun::Initialize_Implementation()
 	WallDetectionQueryParams.AddIgnoredActor(CharacterOwner);
 	WallDetectionQueryParams.bIgnoreTouches = true;
 
+	MovementComponent->RegisterGroundProbeDistance(ConfigData.MinDistanceFromGround);
+
+	SurfaceFilter.Compile(SurfaceSubsystem, ConfigData.WallRunnableSurfaceTag, ConfigData.SurfaceExclusionTags);
+	if (ConfigData.bUseTraversalIndex)
+		RegisterTraversalIndexSurfaceFilter(SurfaceFilter);
+
+	const int32 GroundCheckIgnoredCategoryBit = IsValid(SurfaceSubsystem)
+		                                            ? SurfaceSubsystem->RegisterCategory(ConfigData.GroundCheckIgnoredSurfaceTag)
+		                                            : INDEX_NONE;
+	GroundCheckIgnoredCategoryMask = GroundCheckIgnoredCategoryBit != INDEX_NONE ? 1ull << GroundCheckIgnoredCategoryBit : 0;
+
 	RuntimeData.CooldownTimer = FMManualTimer(ConfigData.CooldownTime);
 	RuntimeData.CooldownTimer.Complete();
 
@@ -33,62 +58,54 @@ void UMMovementMode_WallRun::Tick_Implementation(float DeltaTime)
 {
 	Super::Tick_Implementation(DeltaTime);
 
-	SweepAndCalculateSurfaceInfo();
+	SweepAndCalculateSurfaceInfo(DeltaTime);
+
+	TickTimerWithActivationWake(RuntimeData.CooldownTimer, DeltaTime);
 
-	RuntimeData.CooldownTimer.Tick(DeltaTime);
+	// Speed, facing and height checked by CanStart change every frame, keep evaluating it while falling next to a wall
+	if (RuntimeData.SurfaceInfo.bValid && MovementComponent->IsFalling())
+		WakeActivationCheck(EMMovementModeWakeCondition::SurfaceSensorChanged);
 }
 
-bool UMMovementMode_WallRun::CanStart_Implementation(FString& OutFailReason)
+bool UMMovementMode_WallRun::CanStart_Implementation(FMMovementMode_FailReason& OutFailReason)
 {
 	if (!MovementComponent->IsFalling())
 	{
-		OutFailReason = TEXT("Character is not falling");
+		OutFailReason = EMMovementMode_FailReasonCode::NotFalling;
 		return false;
 	}
 
-	UMMovementMode_Base* ActiveCustomMovementModeInstance = MovementComponent->GetActiveCustomMovementModeInstance();
-	if (IsValid(ActiveCustomMovementModeInstance))
-	{
-		if (ActiveCustomMovementModeInstance->IsA<UMMovementMode_WallRun>())
-		{
-			OutFailReason = TEXT("Wall Run is active");
-			return false;
-		}
-	}
-
 	if (!RuntimeData.CooldownTimer.IsCompleted())
 	{
-		OutFailReason = TEXT("Cooldown");
+		OutFailReason = EMMovementMode_FailReasonCode::Cooldown;
 		return false;
 	}
 
 	if (!RuntimeData.SurfaceInfo.bValid)
 	{
-		OutFailReason = TEXT("Surface is not valid for wall run");
+		OutFailReason = EMMovementMode_FailReasonCode::SurfaceInvalid;
 		return false;
 	}
 
 	const float HorizontalSpeed = MovementComponent->GetPeakTemporalHorizontalVelocity().Size();
 	if (HorizontalSpeed < ConfigData.MinHorizontalSpeedToStart)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Horizontal speed is too low (hspeed: %.2f, min: %.2f)"), HorizontalSpeed, ConfigData.MinHorizontalSpeedToStart);
-
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::HorizontalSpeedTooLow,
+		                                          HorizontalSpeed, ConfigData.MinHorizontalSpeedToStart);
 		return false;
 	}
 
 	const float VerticalSpeed = MovementComponent->Velocity.Z;
 	if (VerticalSpeed < ConfigData.MinVerticalSpeedToStart)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Vertical speed is too low (vspeed: %.2f, min: %.2f)"), VerticalSpeed, ConfigData.MinVerticalSpeedToStart);
-
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::VerticalSpeedTooLow,
+		                                          VerticalSpeed, ConfigData.MinVerticalSpeedToStart);
 		return false;
 	}
 
 	if (!IsHighEnoughFromGround())
 	{
-		OutFailReason = TEXT("Too close to ground");
+		OutFailReason = EMMovementMode_FailReasonCode::TooCloseToGround;
 		return false;
 	}
 
@@ -98,19 +115,17 @@ bool UMMovementMode_WallRun::CanStart_Implementation(FString& OutFailReason)
 
 	if (AngleBetweenCharacterNormalAndSurfaceNormal < ConfigData.MinAngleBetweenSurfaceNormalAndCharacterForwardToStart)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Angle between character forward and surface normal too low (angle: %.2f, min: %.2f)"),
-			AngleBetweenCharacterNormalAndSurfaceNormal, ConfigData.MinAngleBetweenSurfaceNormalAndCharacterForwardToStart);
-
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::SurfaceToForwardAngleTooLow,
+		                                          AngleBetweenCharacterNormalAndSurfaceNormal,
+		                                          ConfigData.MinAngleBetweenSurfaceNormalAndCharacterForwardToStart);
 		return false;
 	}
 
 	if (AngleBetweenCharacterNormalAndSurfaceNormal > ConfigData.MaxAngleBetweenSurfaceNormalAndCharacterForwardToStart)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Angle between character forward and surface normal too high (angle: %.2f, max: %.2f)"),
-			AngleBetweenCharacterNormalAndSurfaceNormal, ConfigData.MaxAngleBetweenSurfaceNormalAndCharacterForwardToStart);
-
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::SurfaceToForwardAngleTooHigh,
+		                                          AngleBetweenCharacterNormalAndSurfaceNormal,
+		                                          ConfigData.MaxAngleBetweenSurfaceNormalAndCharacterForwardToStart);
 		return false;
 	}
 
@@ -119,7 +134,7 @@ bool UMMovementMode_WallRun::CanStart_Implementation(FString& OutFailReason)
 		if (FVector::DotProduct(MMath::ToHorizontalDirection(CharacterOwner->GetActorForwardVector()),
 		                        MMath::ToHorizontalDirection(MovementComponent->Velocity)) < 0)
 		{
-			OutFailReason = TEXT("Can't wall run backwards, because it's not activated in config");
+			OutFailReason = EMMovementMode_FailReasonCode::CannotRunBackwards;
 
 			return false;
 		}
@@ -128,34 +143,33 @@ bool UMMovementMode_WallRun::CanStart_Implementation(FString& OutFailReason)
 	return true;
 }
 
-bool UMMovementMode_WallRun::CanContinue(FString& OutFailReason) const
+bool UMMovementMode_WallRun::CanContinue(FMMovementMode_FailReason& OutFailReason) const
 {
 	if (!RuntimeData.SurfaceInfo.bValid)
 	{
-		OutFailReason = TEXT("Surface is not valid for wall run");
+		OutFailReason = EMMovementMode_FailReasonCode::SurfaceInvalid;
 		return false;
 	}
 
 	const float VerticalSpeed = MovementComponent->Velocity.Z;
 	if (VerticalSpeed < ConfigData.MinVerticalSpeedToContinue)
 	{
-		OutFailReason = FString::Printf(
-			TEXT("Vertical speed is too low (vspeed: %.2f, min: %.2f)"), VerticalSpeed, ConfigData.MinVerticalSpeedToContinue);
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::VerticalSpeedTooLow,
+		                                          VerticalSpeed, ConfigData.MinVerticalSpeedToContinue);
 		return false;
 	}
 
 	if (!IsHighEnoughFromGround())
 	{
-		OutFailReason = TEXT("Too close to ground");
+		OutFailReason = EMMovementMode_FailReasonCode::TooCloseToGround;
 		return false;
 	}
 
 	const float SurfaceNormalDeltaAngle = MMath::AngleBetweenVectorsDeg(RuntimeData.SurfaceInfo.Normal, RuntimeData.SurfaceInfoOld.Normal);
 	if (SurfaceNormalDeltaAngle > ConfigData.MaxSurfaceNormalAngleChangeToContinue)
 	{
-		OutFailReason = FString::Printf(TEXT("Surface normal angle delta too high (angle: %.2f, max: %.2f)"),
-		                                SurfaceNormalDeltaAngle,
-		                                ConfigData.MaxSurfaceNormalAngleChangeToContinue);
+		OutFailReason = FMMovementMode_FailReason(EMMovementMode_FailReasonCode::SurfaceNormalAngleChangeTooHigh,
+		                                          SurfaceNormalDeltaAngle, ConfigData.MaxSurfaceNormalAngleChangeToContinue);
 		return false;
 	}
 
@@ -168,6 +182,8 @@ void UMMovementMode_WallRun::Start_Implementation()
 
 	RuntimeData.GravityApexTimer = ConfigData.GravityApexTime;
 	RuntimeData.HorizontalSpeed = MovementComponent->GetPeakTemporalHorizontalVelocity().Size2D();
+
+	TryAttachToRail();
 }
 
 void UMMovementMode_WallRun::Phys_Implementation(float DeltaTime, int32 Iterations)
@@ -195,7 +211,7 @@ void UMMovementMode_WallRun::Phys_Implementation(float DeltaTime, int32 Iteratio
 		ActivateCooldown();
 
 		MovementComponent->AddControlledLaunchFromAsset(JumpOffVelocity, ConfigData.JumpOffControlledLaunchAsset, this);
-		UE_VLOG_ARROW(CharacterOwner, LogMMovement, Display, UpdatedComponent->GetComponentLocation(),
+		MMOVEMENT_VLOG_ARROW(CharacterOwner, LogMMovement, Display, UpdatedComponent->GetComponentLocation(),
 		              UpdatedComponent->GetComponentLocation() + JumpOffVelocity, FColor::Blue, TEXT("Wall Run jump off"));
 
 		MovementComponent->OnJumpedDelegate.Broadcast();
@@ -205,12 +221,12 @@ void UMMovementMode_WallRun::Phys_Implementation(float DeltaTime, int32 Iteratio
 		return;
 	}
 
-	FString CanContinueFailReason;
+	FMMovementMode_FailReason CanContinueFailReason;
 	if (!CanContinue(CanContinueFailReason))
 	{
-		UE_VLOG(CharacterOwner, LogMMovement, Display, TEXT("%s CanContinue fail reason: %s"),
+		MMOVEMENT_VLOG(CharacterOwner, LogMMovement, Display, TEXT("%s CanContinue fail reason: %s"),
 		        *MovementModeName.ToString(),
-		        *CanContinueFailReason);
+		        *CanContinueFailReason.ToString());
 
 		MovementComponent->SetMovementMode(MOVE_Falling);
 		MovementComponent->StartNewPhysics(DeltaTime, Iterations);
@@ -254,7 +270,7 @@ void UMMovementMode_WallRun::Phys_Implementation(float DeltaTime, int32 Iteratio
 			RuntimeData.GravityApexTimer.Tick(DeltaTime);
 			VerticalSpeed = 0;
 
-			if (CVarShowMovementDebugs.GetValueOnGameThread())
+			if (ShouldShowMovementDebugs())
 			{
 				GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Blue,
 				                                 FString::Printf(TEXT("Wall Run Apex %.1f"), RuntimeData.GravityApexTimer.GetTimeLeft()));
@@ -271,31 +287,20 @@ void UMMovementMode_WallRun::Phys_Implementation(float DeltaTime, int32 Iteratio
 	MovementComponent->Velocity = VelocityProjectedScaled;
 	MovementComponent->SetAcceleration(HorizontalAcceleration * HorizontalDirection);
 
-	// Move along surface
+	// Rail replaces the surface sensing and the snap, only the move itself is swept
+	if (IsAttachedToRail() && MoveAlongRail(DeltaTime, VerticalSpeed))
+		return;
+
+	// Move along surface and snap to surface we are running on
 	const FVector LocationDelta = MovementComponent->Velocity * DeltaTime;
 
 	FHitResult Hit(1.f);
-
-	MovementComponent->SafeMoveUpdatedComponent(LocationDelta, UpdatedComponent->GetComponentQuat(), true, Hit);
-
-	if (Hit.Time < 1.f)
+	MovementComponent->SafeMoveUpdatedComponentWithSnap(LocationDelta, DeltaTime, [this, DeltaTime](const FVector& Location)
 	{
-		MovementComponent->HandleImpact(Hit, DeltaTime, LocationDelta);
-		MovementComponent->SlideAlongSurface(LocationDelta, (1.0f - Hit.Time), Hit.Normal, Hit, true);
-	}
-
-	// Snap to surface we are running on
-	const FVector ToSurfaceNormal = FVector::VectorPlaneProject(-GetSurfaceNormal(), FVector::UpVector).GetSafeNormal();
-	const FVector Location = UpdatedComponent->GetComponentLocation();
-	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
-
-	const FVector Difference = (GetSnapLocation() - Location).ProjectOnTo(ToSurfaceNormal);
-	const FVector Offset = -GetSurfaceNormal() * (Difference.Length() - ConfigData.OffsetFromWall);
+		return CalculateWallSnapDelta(Location, DeltaTime);
+	}, Hit);
 
-	constexpr bool bSweep = true;
-	UpdatedComponent->MoveComponent(Offset * ConfigData.WallOffsetSnapSpeed * DeltaTime, Rotation, bSweep);
-
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		DrawDebugPoint(GetWorld(), UpdatedComponent->GetComponentLocation(), 5, FColor::White, false, 5, 5);
 	}
@@ -304,6 +309,8 @@ void UMMovementMode_WallRun::Phys_Implementation(float DeltaTime, int32 Iteratio
 void UMMovementMode_WallRun::End_Implementation()
 {
 	Super::End_Implementation();
+
+	DetachFromRail();
 }
 
 bool UMMovementMode_WallRun::IsMovingOnGround_Implementation()
@@ -359,8 +366,54 @@ void UMMovementMode_WallRun::ActivateCooldown()
 	RuntimeData.CooldownTimer.Reset();
 }
 
-void UMMovementMode_WallRun::SweepAndCalculateSurfaceInfo()
+bool UMMovementMode_WallRun::AllowsMovementSleep() const
+{
+	return Super::AllowsMovementSleep() && RuntimeData.CooldownTimer.IsCompleted();
+}
+
+void UMMovementMode_WallRun::SweepAndCalculateSurfaceInfo(const float DeltaTime)
 {
+	// Wall found, lost or replaced by another one is signaled for modes waking on SurfaceSensorChanged
+	const bool bSurfaceValidPrevious = RuntimeData.SurfaceInfo.bValid;
+	const UPrimitiveComponent* SurfaceComponentPrevious = RuntimeData.SurfaceInfo.PrimitiveComponent;
+	ON_SCOPE_EXIT
+	{
+		if (RuntimeData.SurfaceInfo.bValid != bSurfaceValidPrevious || RuntimeData.SurfaceInfo.PrimitiveComponent != SurfaceComponentPrevious)
+			WakeActivationCheck(EMMovementModeWakeCondition::SurfaceSensorChanged);
+	};
+
+	if (IsAttachedToRail())
+	{
+		UpdateSurfaceInfoFromRail();
+		return;
+	}
+
+	if (RevalidatePreviousSurface())
+	{
+		// Any async sweep in flight would be stale by the time full sweep is needed again
+		SurfaceSensor.Reset();
+
+		RuntimeData.FramesSinceFullSweep++;
+		RuntimeData.SurfaceRevalidationSuccessCount++;
+		INC_DWORD_STAT(STAT_MMovement_WallRunSurfaceRevalidations);
+		return;
+	}
+
+	FMCharacterMovement_WallRunSurfaceInfo FieldSurfaceInfo;
+	if (ConfigData.bUseTraversalField && FindSurfaceInTraversalField(FieldSurfaceInfo))
+	{
+		SurfaceSensor.Reset();
+
+		RuntimeData.SurfaceInfoOld = RuntimeData.SurfaceInfo;
+		RuntimeData.SurfaceInfo = FieldSurfaceInfo;
+		INC_DWORD_STAT(STAT_MMovement_WallRunTraversalFieldLookups);
+		return;
+	}
+
+	RuntimeData.FramesSinceFullSweep = 0;
+	RuntimeData.FullSweepCount++;
+	INC_DWORD_STAT(STAT_MMovement_WallRunFullSurfaceSweeps);
+
 	auto CapsuleComponent = CharacterOwner->GetCapsuleComponent();
 	const FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(
 		CapsuleComponent->GetScaledCapsuleRadius() * ConfigData.WallDetectionCapsuleSizeMultiplier,
@@ -374,25 +427,107 @@ void UMMovementMode_WallRun::SweepAndCalculateSurfaceInfo()
 	const FVector End = Start + UpdatedComponent->GetForwardVector() * 5;
 
 	TArray<FHitResult> Hits;
-	GetWorld()->SweepMultiByChannel(Hits, Start, End, FQuat::Identity,
-	                                ECC_WorldStatic, CollisionShape, WallDetectionQueryParams);
+	if (ConfigData.bUseTraversalIndex && IsValid(TraversalIndexSubsystem)
+		&& TraversalIndexSubsystem->QueryCapsule(Start, End, CollisionShape.GetCapsuleRadius(), CollisionShape.GetCapsuleHalfHeight(),
+		                                         SurfaceFilter, Hits))
+	{
+		// Any async sweep in flight would be stale by the time index can't answer
+		SurfaceSensor.Reset();
+	}
+	else if (ConfigData.SurfaceSensingMode == EMMovementSurfaceSensingMode::Async)
+	{
+		if (!SurfaceSensor.ConsumeAsyncSweep(GetWorld(), Start, ConfigData.AsyncSensingMaxPredictionError, Hits))
+		{
+			FMMovementSurfaceSensor::SweepSync(GetWorld(), Start, End, ConfigData.SurfaceQueryConfig, CollisionShape,
+			                                   WallDetectionQueryParams, Hits);
+		}
+
+		// Request next frame's sweep from where character is expected to be by then
+		const FVector PredictedOffset = MovementComponent->Velocity * DeltaTime;
+		SurfaceSensor.RequestAsyncSweep(GetWorld(), Start + PredictedOffset, End + PredictedOffset,
+		                                ConfigData.SurfaceQueryConfig, CollisionShape, WallDetectionQueryParams);
+	}
+	else
+	{
+		if (SurfaceSensor.HasPendingRequest())
+			SurfaceSensor.Reset();
+
+		FMMovementSurfaceSensor::SweepSync(GetWorld(), Start, End, ConfigData.SurfaceQueryConfig, CollisionShape,
+		                                   WallDetectionQueryParams, Hits);
+	}
 
 	RuntimeData.SurfaceInfoOld = RuntimeData.SurfaceInfo;
 	RuntimeData.SurfaceInfo = CalculateSurfaceInfo(Hits);
 
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
 		DrawDebugCapsule(GetWorld(), Start, CollisionShape.GetCapsuleHalfHeight(), CollisionShape.GetCapsuleRadius(),
 		                 FQuat::Identity, FColor::White);
 	}
 }
 
+bool UMMovementMode_WallRun::RevalidatePreviousSurface()
+{
+	if (!ConfigData.bRevalidatePreviousSurfaceWhileActive || !IsMovementModeActive())
+		return false;
+
+	if (RuntimeData.FramesSinceFullSweep >= ConfigData.FullSweepFrameInterval)
+		return false;
+
+	const FMCharacterMovement_WallRunSurfaceInfo& SurfaceInfoPrevious = RuntimeData.SurfaceInfo;
+	if (!SurfaceInfoPrevious.bValid || !IsValid(SurfaceInfoPrevious.PrimitiveComponent))
+		return false;
+
+	// Same reach as the full sweep with wall detection capsule
+	const float MaxDistance = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() * ConfigData.WallDetectionCapsuleSizeMultiplier;
+
+	const FVector TraceStart = UpdatedComponent->GetComponentLocation();
+	const FVector TraceEnd = TraceStart - SurfaceInfoPrevious.Normal * MaxDistance;
+
+	FHitResult Hit;
+	if (!SurfaceInfoPrevious.PrimitiveComponent->LineTraceComponent(Hit, TraceStart, TraceEnd, WallDetectionQueryParams))
+		return false;
+
+	const float SurfaceNormalDeltaAngle = MMath::AngleBetweenVectorsDeg(Hit.ImpactNormal, SurfaceInfoPrevious.Normal);
+	if (SurfaceNormalDeltaAngle > ConfigData.RevalidationMaxSurfaceNormalAngleChange)
+		return false;
+
+	const float SurfaceAngle = MMath::SignedAngleBetweenVectorsDeg(FVector::UpVector, Hit.ImpactNormal);
+	if (SurfaceAngle < ConfigData.WallRunnableSurfaceNormalAngleMin || SurfaceAngle > ConfigData.WallRunnableSurfaceNormalAngleMax)
+		return false;
+
+	// Tags don't need to be checked again, component passed them in the full sweep
+	FMCharacterMovement_WallRunSurfaceInfo SurfaceInfoNew;
+	SurfaceInfoNew.bValid = true;
+	SurfaceInfoNew.SnapLocation = Hit.ImpactPoint;
+	SurfaceInfoNew.Normal = Hit.ImpactNormal;
+	SurfaceInfoNew.PrimitiveComponent = SurfaceInfoPrevious.PrimitiveComponent;
+
+	RuntimeData.SurfaceInfoOld = RuntimeData.SurfaceInfo;
+	RuntimeData.SurfaceInfo = SurfaceInfoNew;
+
+	if (ShouldShowMovementDebugs())
+		DrawDebugLine(GetWorld(), TraceStart, Hit.ImpactPoint, FColor::Cyan);
+
+	return true;
+}
+
 FVector UMMovementMode_WallRun::GetSurfaceNormal() const
 {
 	return RuntimeData.SurfaceInfo.Normal;
 }
 
+FVector UMMovementMode_WallRun::CalculateWallSnapDelta(const FVector& Location, const float DeltaTime) const
+{
+	const FVector ToSurfaceNormal = FVector::VectorPlaneProject(-GetSurfaceNormal(), FVector::UpVector).GetSafeNormal();
+
+	const FVector Difference = (GetSnapLocation() - Location).ProjectOnTo(ToSurfaceNormal);
+	const FVector Offset = -GetSurfaceNormal() * (Difference.Length() - ConfigData.OffsetFromWall);
+
+	return Offset * ConfigData.WallOffsetSnapSpeed * DeltaTime;
+}
+
 FVector UMMovementMode_WallRun::GetSnapLocation() const
 {
 	return RuntimeData.SurfaceInfo.SnapLocation;
@@ -453,14 +588,13 @@ FVector UMMovementMode_WallRun::GetJumpOffVelocity() const
 bool UMMovementMode_WallRun::IsHighEnoughFromGround() const
 {
 	// Check if ground is far enough
-	FHitResult GroundTraceHitResult;
-	const FVector TraceStart = UpdatedComponent->GetComponentLocation();
-	const FVector TraceEnd = TraceStart + FVector::DownVector * ConfigData.MinDistanceFromGround;
-	bool bGroundHit = GetWorld()->LineTraceSingleByChannel(GroundTraceHitResult, TraceStart, TraceEnd, ECC_WorldStatic,
-	                                                       WallDetectionQueryParams);
+	const FMMovementGroundProbeResult& GroundProbe = MovementComponent->ProbeGround(ConfigData.MinDistanceFromGround);
+	const bool bGroundHit = GroundProbe.IsGroundWithin(ConfigData.MinDistanceFromGround);
 
-	if (CVarShowMovementDebugs.GetValueOnGameThread())
+	if (ShouldShowMovementDebugs())
 	{
+		const FVector TraceStart = UpdatedComponent->GetComponentLocation();
+		const FVector TraceEnd = TraceStart + FVector::DownVector * ConfigData.MinDistanceFromGround;
 		const FColor DebugColor = bGroundHit ? FColor::Red : FColor::Green;
 		DrawDebugLine(GetWorld(), TraceStart, TraceEnd, DebugColor, false, 3);
 		DrawDebugString(GetWorld(), TraceEnd, TEXT("Ground height test"), 0, DebugColor, 3, true);
@@ -468,8 +602,11 @@ bool UMMovementMode_WallRun::IsHighEnoughFromGround() const
 
 	if (bGroundHit)
 	{
-		// TODO: check for tags in config instead of hardcoded value
-		if (!GroundTraceHitResult.GetComponent()->ComponentHasTag(WallRunnableTagName))
+		// Subsystem doesn't exist in preview and inactive worlds
+		const bool bGroundIgnored = IsValid(SurfaceSubsystem)
+			                            ? (SurfaceSubsystem->GetSurfaceCategoryMask(GroundProbe.GetComponent()) & GroundCheckIgnoredCategoryMask) != 0
+			                            : IsValid(GroundProbe.GetComponent()) && GroundProbe.GetComponent()->ComponentHasTag(ConfigData.GroundCheckIgnoredSurfaceTag);
+		if (!bGroundIgnored)
 			return false;
 	}
 
@@ -477,57 +614,238 @@ bool UMMovementMode_WallRun::IsHighEnoughFromGround() const
 }
 
 
+void UMMovementMode_WallRun::TryAttachToRail()
+{
+	if (!ConfigData.bUseWallRunRails || !IsValid(RuntimeData.SurfaceInfo.PrimitiveComponent))
+		return;
+
+	const AActor* WallOwner = RuntimeData.SurfaceInfo.PrimitiveComponent->GetOwner();
+	if (WallOwner == nullptr)
+		return;
+
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+
+	UMWallRunRailComponent* ClosestRail = nullptr;
+	float ClosestRailDistance = 0;
+	float ClosestDistanceSquared = FMath::Square(ConfigData.RailAttachMaxDistance);
+
+	TInlineComponentArray<UMWallRunRailComponent*> Rails(WallOwner);
+	for (UMWallRunRailComponent* Rail : Rails)
+	{
+		const float RailDistance = Rail->FindDistanceClosestToLocation(Location);
+
+		FVector RunnerLocation, WallNormal, RailDirection;
+		Rail->GetRunnerFrameAtDistance(RailDistance, RunnerLocation, WallNormal, RailDirection);
+
+		const float DistanceSquared = FVector::DistSquared2D(Location, RunnerLocation);
+		if (DistanceSquared > ClosestDistanceSquared)
+			continue;
+
+		ClosestRail = Rail;
+		ClosestRailDistance = RailDistance;
+		ClosestDistanceSquared = DistanceSquared;
+	}
+
+	if (ClosestRail == nullptr)
+		return;
+
+	FVector RunnerLocation, WallNormal, RailDirection;
+	ClosestRail->GetRunnerFrameAtDistance(ClosestRailDistance, RunnerLocation, WallNormal, RailDirection);
+
+	RuntimeData.Rail = ClosestRail;
+	RuntimeData.RailDistance = ClosestRailDistance;
+	RuntimeData.RailDirectionSign = FVector::DotProduct(MovementComponent->Velocity, RailDirection) >= 0 ? 1 : -1;
+
+	SurfaceSensor.Reset();
+	UpdateSurfaceInfoFromRail();
+
+	MMOVEMENT_VLOG(CharacterOwner, LogMMovement, Display, TEXT("%s attached to rail %s"), *MovementModeName.ToString(),
+	        *GetNameSafe(ClosestRail));
+}
+
+void UMMovementMode_WallRun::DetachFromRail()
+{
+	RuntimeData.Rail = nullptr;
+}
+
+void UMMovementMode_WallRun::UpdateSurfaceInfoFromRail()
+{
+	if (!IsValid(RuntimeData.Rail))
+	{
+		DetachFromRail();
+		return;
+	}
+
+	FVector RunnerLocation, WallNormal, RailDirection;
+	RuntimeData.Rail->GetRunnerFrameAtDistance(RuntimeData.RailDistance, RunnerLocation, WallNormal, RailDirection);
+
+	// Component of the wall is kept, it stays the movement base
+	RuntimeData.SurfaceInfoOld = RuntimeData.SurfaceInfo;
+	RuntimeData.SurfaceInfo.bValid = true;
+	RuntimeData.SurfaceInfo.Normal = WallNormal;
+	RuntimeData.SurfaceInfo.SnapLocation = RunnerLocation - WallNormal * RuntimeData.Rail->GetOffsetFromWall();
+}
+
+bool UMMovementMode_WallRun::MoveAlongRail(const float DeltaTime, const float VerticalSpeed)
+{
+	float NewRailDistance = RuntimeData.RailDistance + RuntimeData.RailDirectionSign * RuntimeData.HorizontalSpeed * DeltaTime;
+	if (!RuntimeData.Rail->WrapDistance(NewRailDistance))
+	{
+		// End of the rail, continue by sensing the wall, which ends wall run if there is no wall
+		DetachFromRail();
+		return false;
+	}
+
+	FVector RunnerLocation, WallNormal, RailDirection;
+	RuntimeData.Rail->GetRunnerFrameAtDistance(NewRailDistance, RunnerLocation, WallNormal, RailDirection);
+
+	// Distance to the rail along the wall normal is closed at the wall offset snap speed, the same as when following the wall by sensing
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	const FVector ToRunnerLocation = FVector::VectorPlaneProject(RunnerLocation - Location, FVector::UpVector);
+	const FVector ToRunnerLocationAlongNormal = ToRunnerLocation.ProjectOnToNormal(WallNormal);
+	const float SnapAlpha = FMath::Min(ConfigData.WallOffsetSnapSpeed * DeltaTime, 1.f);
+
+	const FVector LocationDelta = ToRunnerLocation - ToRunnerLocationAlongNormal * (1 - SnapAlpha) + FVector::UpVector * VerticalSpeed * DeltaTime;
+
+	MovementComponent->Velocity = RailDirection * RuntimeData.RailDirectionSign * RuntimeData.HorizontalSpeed
+		+ FVector::UpVector * VerticalSpeed;
+
+	FHitResult Hit(1.f);
+	MovementComponent->SafeMoveUpdatedComponent(LocationDelta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+	if (Hit.Time < 1.f)
+	{
+		MovementComponent->HandleImpact(Hit, DeltaTime, LocationDelta);
+		MovementComponent->SlideAlongSurface(LocationDelta, (1.0f - Hit.Time), Hit.Normal, Hit, true);
+
+		// Obstacle pushed character off the rail, continue by sensing the wall
+		DetachFromRail();
+		return true;
+	}
+
+	RuntimeData.RailDistance = NewRailDistance;
+
+	if (ShouldShowMovementDebugs())
+	{
+		DrawDebugPoint(GetWorld(), UpdatedComponent->GetComponentLocation(), 5, FColor::Cyan, false, 5, 5);
+	}
+
+	return true;
+}
+
+bool UMMovementMode_WallRun::FindSurfaceInTraversalField(FMCharacterMovement_WallRunSurfaceInfo& OutSurfaceInfo) const
+{
+	if (!IsValid(TraversalFieldSubsystem) || !TraversalFieldSubsystem->HasFields())
+		return false;
+
+	// Same reach as the full sweep with wall detection capsule
+	const float MaxDistance = CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleRadius() * ConfigData.WallDetectionCapsuleSizeMultiplier;
+
+	bool bFound;
+	FMTraversalFieldSample Sample;
+	if (!TraversalFieldSubsystem->FindSurface(UpdatedComponent->GetComponentLocation(), MaxDistance, SurfaceFilter, bFound, Sample))
+		return false;
+
+	// Field has only baked static surfaces and the nearest one per cell, so a miss doesn't mean there is no wall (e.g., a movable one)
+	if (!bFound)
+		return false;
+
+	const float SurfaceAngle = MMath::SignedAngleBetweenVectorsDeg(FVector::UpVector, Sample.SurfaceNormal);
+	if (SurfaceAngle < ConfigData.WallRunnableSurfaceNormalAngleMin || SurfaceAngle > ConfigData.WallRunnableSurfaceNormalAngleMax)
+		return false;
+
+	// Field doesn't keep components, the one at the sample is resolved with a short trace into the surface
+	// Component is needed as movement base, for surface revalidation and for attaching to rails
+	constexpr float ComponentTraceOffset = 5;
+	const FVector TraceStart = Sample.SurfacePoint + Sample.SurfaceNormal * ComponentTraceOffset;
+	const FVector TraceEnd = Sample.SurfacePoint - Sample.SurfaceNormal * ComponentTraceOffset;
+
+	FHitResult ComponentHit;
+	if (!ConfigData.SurfaceQueryConfig.LineTraceSingle(GetWorld(), ComponentHit, TraceStart, TraceEnd, WallDetectionQueryParams)
+		|| !IsValid(ComponentHit.GetComponent()))
+	{
+		return false;
+	}
+
+	OutSurfaceInfo = FMCharacterMovement_WallRunSurfaceInfo();
+	OutSurfaceInfo.bValid = true;
+	OutSurfaceInfo.SnapLocation = Sample.SurfacePoint;
+	OutSurfaceInfo.Normal = Sample.SurfaceNormal;
+	OutSurfaceInfo.PrimitiveComponent = ComponentHit.GetComponent();
+
+	return true;
+}
+
 FMCharacterMovement_WallRunSurfaceInfo UMMovementMode_WallRun::CalculateSurfaceInfo(const TArray<FHitResult>& Hits)
 {
 	TArray<FMCharacterMovement_WallRunSurfaceHitInfo> SurfaceHitInfoArray;
-	TArray<FString> SurfaceValidationLogArray;
+
+	// Validation is recorded only when somebody looks at it
+	const bool bRecordDiagnostics = ShouldRecordMovementDiagnostics();
+	TArray<FMMovementSurfaceValidationRecord, TInlineAllocator<8>> ValidationRecords;
+
+	// Sweep can return several hits on the same component, only the first valid one is used
+	// Component is added only after its hit passes validation, so a failing hit doesn't discard later hits on it
+	TArray<const UPrimitiveComponent*, TInlineAllocator<8>> ValidatedComponents;
 
 	// Filter hits to have only correct wall hits
 	for (const FHitResult& Hit : Hits)
 	{
-		SurfaceValidationLogArray.Add(FString::Printf(TEXT("%s surface validation %s> "),
-		                                              *GetMovementModeName().ToString(),
-		                                              *Hit.GetActor()->GetActorNameOrLabel()));
+		FMMovementSurfaceValidationRecord ValidationRecord(Hit.GetActor(), EMMovementSurfaceValidationResult::Valid);
 
-		// Check if surface has wall runnable tag
-		if (!ConfigData.WallRunnableSurfaceTag.IsNone() && !Hit.GetComponent()->ComponentHasTag(ConfigData.WallRunnableSurfaceTag))
+		ON_SCOPE_EXIT
 		{
-			FString& ValidationLog = SurfaceValidationLogArray.Last();
-			ValidationLog += FString::Printf(
-				TEXT("Invalid - Surface doesn't contain %s tag"), *ConfigData.WallRunnableSurfaceTag.ToString());
+			if (bRecordDiagnostics)
+				ValidationRecords.Add(ValidationRecord);
+		};
+
+		if (ValidatedComponents.Contains(Hit.GetComponent()))
+		{
+			INC_DWORD_STAT(STAT_MMovement_SurfaceAssistQueriesSkipped);
+			ValidationRecord.Result = EMMovementSurfaceValidationResult::ComponentAlreadyValidated;
 
 			continue;
 		}
 
-		// Check if surface doesn't have any of specified exclusion tags
-		bool bExcludedFromTag = false;
-		for (const FName& ExclusionTag : ConfigData.SurfaceExclusionTags)
+		// Check if surface has wall runnable category and none of the exclusion categories
+		FName ExcludedCategory;
+		const EMMovementSurfaceFilterResult SurfaceFilterResult = ClassifySurface(SurfaceFilter, Hit.GetComponent(),
+		                                                                          bRecordDiagnostics ? &ExcludedCategory : nullptr);
+		if (SurfaceFilterResult == EMMovementSurfaceFilterResult::MissingRequiredCategory)
 		{
-			if (Hit.GetComponent()->ComponentHasTag(ExclusionTag))
-			{
-				bExcludedFromTag = true;
-				break;
-			}
+			ValidationRecord.Result = EMMovementSurfaceValidationResult::MissingRequiredCategory;
+			ValidationRecord.Category = ConfigData.WallRunnableSurfaceTag;
+
+			continue;
 		}
 
-		if (bExcludedFromTag)
+		if (SurfaceFilterResult == EMMovementSurfaceFilterResult::ExcludedCategory)
 		{
-			FString& ValidationLog = SurfaceValidationLogArray.Last();
-			ValidationLog += TEXT("Invalid - Surface contains exclusion tag");
+			ValidationRecord.Result = EMMovementSurfaceValidationResult::ExcludedCategory;
+			ValidationRecord.Category = ExcludedCategory;
 
 			continue;
 		}
 
-		const FVector AssistTraceStart = UpdatedComponent->GetComponentLocation();
-		const FVector AssistTraceEnd = AssistTraceStart + MMath::FromToVectorNormalized(AssistTraceStart, Hit.ImpactPoint) * 300;
-
-		FHitResult AssistHit;
-		if (!GetWorld()->LineTraceSingleByChannel(AssistHit, AssistTraceStart, AssistTraceEnd, ECC_WorldStatic, WallDetectionQueryParams))
+		// Assist trace against the hit component to get a precise normal, unless the sweep already has it
+		FHitResult AssistHit = Hit;
+		if (!FMMovementSurfaceSensor::IsImpactPrecise(Hit))
 		{
-			FString& ValidationLog = SurfaceValidationLogArray.Last();
-			ValidationLog += TEXT("Invalid - Assist line trace did not hit the surface");
+			INC_DWORD_STAT(STAT_MMovement_SurfaceAssistQueries);
 
-			continue;
+			const FVector AssistTraceStart = UpdatedComponent->GetComponentLocation();
+			const FVector AssistTraceEnd = AssistTraceStart + MMath::FromToVectorNormalized(AssistTraceStart, Hit.ImpactPoint) * 300;
+
+			if (!Hit.GetComponent()->LineTraceComponent(AssistHit, AssistTraceStart, AssistTraceEnd, WallDetectionQueryParams))
+			{
+				ValidationRecord.Result = EMMovementSurfaceValidationResult::AssistQueryMissed;
+
+				continue;
+			}
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_MMovement_SurfaceAssistQueriesSkipped);
 		}
 
 		FVector Normal = AssistHit.ImpactNormal;
@@ -537,30 +855,26 @@ FMCharacterMovement_WallRunSurfaceInfo UMMovementMode_WallRun::CalculateSurfaceI
 		const float SurfaceAngle = MMath::SignedAngleBetweenVectorsDeg(FVector::UpVector, Normal);
 		if (SurfaceAngle < ConfigData.WallRunnableSurfaceNormalAngleMin)
 		{
-			FString& ValidationLog = SurfaceValidationLogArray.Last();
-			ValidationLog += FString::Printf(TEXT("Invalid - Surface angle too low (angle: %.2f, min: %.2f)"),
-			                                 SurfaceAngle,
-			                                 ConfigData.WallRunnableSurfaceNormalAngleMin);
+			ValidationRecord.Result = EMMovementSurfaceValidationResult::SurfaceAngleTooLow;
+			ValidationRecord.Value = SurfaceAngle;
+			ValidationRecord.Limit = ConfigData.WallRunnableSurfaceNormalAngleMin;
 
 			continue;
 		}
 
 		if (SurfaceAngle > ConfigData.WallRunnableSurfaceNormalAngleMax)
 		{
-			FString& ValidationLog = SurfaceValidationLogArray.Last();
-			ValidationLog += FString::Printf(TEXT("Invalid - Surface angle too high (angle: %.2f, max: %.2f)"),
-			                                 SurfaceAngle,
-			                                 ConfigData.WallRunnableSurfaceNormalAngleMax);
+			ValidationRecord.Result = EMMovementSurfaceValidationResult::SurfaceAngleTooHigh;
+			ValidationRecord.Value = SurfaceAngle;
+			ValidationRecord.Limit = ConfigData.WallRunnableSurfaceNormalAngleMax;
 
 			continue;
 		}
 
+		ValidatedComponents.Add(Hit.GetComponent());
 		SurfaceHitInfoArray.Emplace(FMCharacterMovement_WallRunSurfaceHitInfo(HitLocation, Normal, Hit.GetComponent()));
 
-		FString& ValidationLog = SurfaceValidationLogArray.Last();
-		ValidationLog += TEXT("Valid");
-
-		if (CVarShowMovementDebugs.GetValueOnGameThread())
+		if (ShouldShowMovementDebugs())
 			DrawDebugLine(GetWorld(), HitLocation, HitLocation + AssistHit.Normal * 50, FColor::Green, false, 5);
 	}
 
@@ -581,17 +895,21 @@ FMCharacterMovement_WallRunSurfaceInfo UMMovementMode_WallRun::CalculateSurfaceI
 		SurfaceInfoResult.PrimitiveComponent = SurfaceHitInfoArray[0].PrimitiveComponent;
 	}
 
-	if (Hits.Num() > 0)
+	if (bRecordDiagnostics)
 	{
-		for (auto& SurfaceValidationLog : SurfaceValidationLogArray)
+		for (const FMMovementSurfaceValidationRecord& ValidationRecord : ValidationRecords)
 		{
-			UE_VLOG(CharacterOwner, LogMMovement, Display, TEXT("%s"), *SurfaceValidationLog);
+			MMOVEMENT_VLOG(CharacterOwner, LogMMovement, Display, TEXT("%s surface validation %s> %s"),
+			               *GetMovementModeName().ToString(),
+			               ValidationRecord.Actor.IsValid() ? *ValidationRecord.Actor->GetActorNameOrLabel() : TEXT("None"),
+			               *ValidationRecord.ToString());
+		}
+
+		if (Hits.IsEmpty())
+		{
+			MMOVEMENT_VLOG(CharacterOwner, LogMMovement, Display, TEXT("%s surface validation> No Sweep hits"),
+			               *GetMovementModeName().ToString());
 		}
-	}
-	else
-	{
-		UE_VLOG(CharacterOwner, LogMMovement, Display, TEXT("%s surface validation> No Sweep hits"),
-		        *GetMovementModeName().ToString());
 	}
 
 	return SurfaceInfoResult;
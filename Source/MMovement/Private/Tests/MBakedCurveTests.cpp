@@ -0,0 +1,102 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#include "MBakedCurve.h"
+#include "Curves/CurveFloat.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MBakedCurveTests
+{
+	// Samples per baked sample interval when comparing against the source curve
+	constexpr int32 SamplesPerInterval = 16;
+
+	UCurveFloat* MakeCurve(const TArray<FVector2f>& Keys, const ERichCurveInterpMode InterpMode)
+	{
+		UCurveFloat* Curve = NewObject<UCurveFloat>();
+		for (const FVector2f& Key : Keys)
+		{
+			const FKeyHandle KeyHandle = Curve->FloatCurve.AddKey(Key.X, Key.Y);
+			Curve->FloatCurve.SetKeyInterpMode(KeyHandle, InterpMode);
+		}
+
+		Curve->FloatCurve.AutoSetTangents();
+		return Curve;
+	}
+
+	// Largest difference between the baked table and the source curve, densely sampled over the curve time range
+	float CalculateMaxError(const UCurveFloat* Curve, const FMBakedCurve& BakedCurve, const int32 SampleCount)
+	{
+		float TimeMin, TimeMax;
+		Curve->GetTimeRange(TimeMin, TimeMax);
+
+		const int32 NumTestSamples = (SampleCount - 1) * SamplesPerInterval;
+		float MaxError = 0;
+		for (int32 TestSample = 0; TestSample <= NumTestSamples; ++TestSample)
+		{
+			const float Time = FMath::Lerp(TimeMin, TimeMax, static_cast<float>(TestSample) / NumTestSamples);
+			MaxError = FMath::Max(MaxError, FMath::Abs(BakedCurve.Evaluate(Time) - Curve->GetFloatValue(Time)));
+		}
+
+		return MaxError;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMBakedCurveAccuracyTest, "MMovement.BakedCurve.Accuracy",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMBakedCurveAccuracyTest::RunTest(const FString& Parameters)
+{
+	using namespace MBakedCurveTests;
+
+	// Ease out distance like dash curves and a multiplier bump like controlled launch curves
+	const UCurveFloat* DistanceCurve = MakeCurve({{0, 0}, {0.2f, 0.6f}, {0.5f, 1}}, RCIM_Cubic);
+	const UCurveFloat* MultiplierCurve = MakeCurve({{0, 1}, {0.3f, 2.5f}, {0.6f, 0.2f}, {1.5f, 1}}, RCIM_Cubic);
+	const UCurveFloat* LinearCurve = MakeCurve({{0, 0}, {1, 10}, {2, -5}}, RCIM_Linear);
+
+	struct FTestCase
+	{
+		const TCHAR* Name;
+		const UCurveFloat* Curve;
+		float Tolerance;
+	};
+
+	const FTestCase TestCases[] = {
+		{TEXT("Distance curve"), DistanceCurve, 0.005f},
+		{TEXT("Multiplier curve"), MultiplierCurve, 0.02f},
+		// Key of linear curve falls between samples, error is bounded by the kink over one sample interval
+		{TEXT("Linear curve"), LinearCurve, 0.25f},
+	};
+
+	for (const FTestCase& TestCase : TestCases)
+	{
+		FMBakedCurve BakedCurve;
+		BakedCurve.Bake(TestCase.Curve);
+
+		const float MaxError = CalculateMaxError(TestCase.Curve, BakedCurve, FMBakedCurve::DefaultSampleCount);
+		AddInfo(FString::Printf(TEXT("%s: max error %f"), TestCase.Name, MaxError));
+		TestTrue(FString::Printf(TEXT("%s max error %f within %f"), TestCase.Name, MaxError, TestCase.Tolerance),
+		         MaxError <= TestCase.Tolerance);
+
+		// Evaluation is clamped to the curve time range
+		float TimeMin, TimeMax;
+		TestCase.Curve->GetTimeRange(TimeMin, TimeMax);
+		TestEqual(FString::Printf(TEXT("%s before time range"), TestCase.Name), BakedCurve.Evaluate(TimeMin - 1),
+		          TestCase.Curve->GetFloatValue(TimeMin), UE_KINDA_SMALL_NUMBER);
+		TestEqual(FString::Printf(TEXT("%s after time range"), TestCase.Name), BakedCurve.Evaluate(TimeMax + 1),
+		          TestCase.Curve->GetFloatValue(TimeMax), UE_KINDA_SMALL_NUMBER);
+	}
+
+	// Single key curve is constant, null curve clears the table
+	const UCurveFloat* ConstantCurve = MakeCurve({{0.5f, 3}}, RCIM_Cubic);
+	FMBakedCurve BakedCurve;
+	BakedCurve.Bake(ConstantCurve);
+	TestEqual(TEXT("Constant curve"), BakedCurve.Evaluate(10), 3.f);
+
+	BakedCurve.Bake(nullptr);
+	TestFalse(TEXT("Null curve is not baked"), BakedCurve.IsBaked());
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,195 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#include "MCharacterMovementComponent.h"
+#include "MMovementTestWorld.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Character.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MCharacterMovementComponentTests
+{
+	constexpr float DeltaTime = 1.f / 60.f;
+	constexpr int32 NumFrames = 60;
+
+	// Wall with its face on plane Y = WallPlaneY, facing -Y
+	constexpr float WallPlaneY = 200.f;
+
+	// Wall run like snap: toward WallOffset from the wall at SnapSpeed
+	constexpr float WallOffset = 5.f;
+	constexpr float SnapSpeed = 10.f;
+
+	// Largest allowed difference between positions reached by the two paths in the same frame
+	constexpr float PositionTolerance = 0.5f;
+
+	struct FMoveResult
+	{
+		TArray<FVector> Locations;
+		int32 NumSingleSweeps = 0;
+	};
+
+	/**
+	 * Moves the character from Start by Delta every frame, with the snap folded into the move (SafeMoveUpdatedComponentWithSnap)
+	 * or with the two step path surface attached modes used before: swept move with slide, then a separate snap sweep
+	 */
+	FMoveResult Simulate(UMCharacterMovementComponent* MovementComponent, const FVector& Start, const FVector& Delta, const bool bWithSnap)
+	{
+		USceneComponent* UpdatedComponent = MovementComponent->UpdatedComponent;
+		const float CapsuleRadius = CastChecked<UCapsuleComponent>(UpdatedComponent)->GetScaledCapsuleRadius();
+
+		auto CalculateSnapDelta = [CapsuleRadius](const FVector& Location)
+		{
+			const float SnapLocationY = WallPlaneY - CapsuleRadius - WallOffset;
+			return FVector(0, SnapLocationY - Location.Y, 0) * SnapSpeed * DeltaTime;
+		};
+
+		UpdatedComponent->SetWorldLocation(Start, false, nullptr, ETeleportType::TeleportPhysics);
+
+		FMoveResult Result;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+
+			FHitResult Hit(1.f);
+			if (bWithSnap)
+			{
+				if (MovementComponent->SafeMoveUpdatedComponentWithSnap(Delta, DeltaTime, CalculateSnapDelta, Hit))
+					Result.NumSingleSweeps++;
+			}
+			else
+			{
+				MovementComponent->SafeMoveUpdatedComponent(Delta, Rotation, true, Hit);
+
+				if (Hit.Time < 1.f)
+				{
+					MovementComponent->HandleImpact(Hit, DeltaTime, Delta);
+					MovementComponent->SlideAlongSurface(Delta, (1.0f - Hit.Time), Hit.Normal, Hit, true);
+				}
+
+				constexpr bool bSweep = true;
+				UpdatedComponent->MoveComponent(CalculateSnapDelta(UpdatedComponent->GetComponentLocation()), Rotation, bSweep);
+			}
+
+			Result.Locations.Add(UpdatedComponent->GetComponentLocation());
+		}
+
+		return Result;
+	}
+
+	// Slide like ground probing: slide surface detection distance, snap offset above the ground and a flat floor with its top on Z = 0
+	constexpr float GroundProbeDistance = 200.f;
+	constexpr float GroundSnapOffset = 100.f;
+	constexpr float GroundSnapSpeed = 10.f;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMCharacterMovementComponentMoveWithSnapTest, "MMovement.CharacterMovement.MoveWithSnap",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMCharacterMovementComponentMoveWithSnapTest::RunTest(const FString& Parameters)
+{
+	using namespace MCharacterMovementComponentTests;
+
+	FMMovementTestWorld TestWorld;
+	TestWorld.SpawnBox(FVector(0, WallPlaneY + 50.f, 0), FVector(5000, 50, 1000));
+
+	// Obstacle across the path along the wall, only the second run reaches it
+	TestWorld.SpawnBox(FVector(1500, WallPlaneY - 100.f, 0), FVector(50, 100, 1000));
+
+	ACharacter* Character = TestWorld.GetWorld()->SpawnActor<ACharacter>(FVector::ZeroVector, FRotator::ZeroRotator);
+	if (!TestNotNull(TEXT("Character is spawned"), Character))
+		return false;
+
+	// Play is not begun, so neither movement component ticks, moves are driven by the test only
+	UMCharacterMovementComponent* MovementComponent = NewObject<UMCharacterMovementComponent>(Character);
+	MovementComponent->RegisterComponent();
+	MovementComponent->SetUpdatedComponent(Character->GetCapsuleComponent());
+
+	struct FTestCase
+	{
+		const TCHAR* Name;
+		FVector Start;
+		FVector Delta;
+		bool bExpectFallback;
+	};
+
+	const FTestCase TestCases[] = {
+		{TEXT("Along the wall"), FVector(0, 80, 0), FVector(10, 0, 0), false},
+		{TEXT("Into the obstacle"), FVector(1000, 80, 0), FVector(15, 0, 0), true},
+	};
+
+	for (const FTestCase& TestCase : TestCases)
+	{
+		const FMoveResult TwoStepResult = Simulate(MovementComponent, TestCase.Start, TestCase.Delta, false);
+		const FMoveResult WithSnapResult = Simulate(MovementComponent, TestCase.Start, TestCase.Delta, true);
+
+		float MaxDeviation = 0;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			MaxDeviation = FMath::Max(MaxDeviation, FVector::Dist(TwoStepResult.Locations[Frame], WithSnapResult.Locations[Frame]));
+		}
+
+		AddInfo(FString::Printf(TEXT("%s: max deviation %f, %d of %d frames with a single sweep"), TestCase.Name, MaxDeviation,
+		                        WithSnapResult.NumSingleSweeps, NumFrames));
+		TestTrue(FString::Printf(TEXT("%s max deviation %f within %f"), TestCase.Name, MaxDeviation, PositionTolerance),
+		         MaxDeviation <= PositionTolerance);
+
+		if (TestCase.bExpectFallback)
+			TestTrue(FString::Printf(TEXT("%s uses two step fallback"), TestCase.Name), WithSnapResult.NumSingleSweeps < NumFrames);
+		else
+			TestEqual(FString::Printf(TEXT("%s uses single sweeps"), TestCase.Name), WithSnapResult.NumSingleSweeps, NumFrames);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMCharacterMovementComponentGroundProbeReuseTest, "MMovement.CharacterMovement.GroundProbeReuse",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMCharacterMovementComponentGroundProbeReuseTest::RunTest(const FString& Parameters)
+{
+	using namespace MCharacterMovementComponentTests;
+
+	FMMovementTestWorld TestWorld;
+	TestWorld.SpawnBox(FVector(0, 0, -50), FVector(5000, 5000, 50));
+
+	ACharacter* Character = TestWorld.GetWorld()->SpawnActor<ACharacter>(FVector(0, 0, GroundSnapOffset + 20.f), FRotator::ZeroRotator);
+	if (!TestNotNull(TEXT("Character is spawned"), Character))
+		return false;
+
+	// Owner is ignored by the probe only after begin play, capsule doesn't collide so probe sees the floor only
+	UCapsuleComponent* CapsuleComponent = Character->GetCapsuleComponent();
+	CapsuleComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	UMCharacterMovementComponent* MovementComponent = NewObject<UMCharacterMovementComponent>(Character);
+	MovementComponent->RegisterComponent();
+	MovementComponent->SetUpdatedComponent(CapsuleComponent);
+
+	// Slide frame probes before the move, after the move and snaps toward the ground below the new location
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const uint32 TraceCountBefore = MovementComponent->GetGroundProbeTraceCount();
+
+		const FMMovementGroundProbeResult& GroundBeforeMove = MovementComponent->ProbeGround(GroundProbeDistance);
+		TestEqual(TEXT("Ground before move"), GroundBeforeMove.Distance, static_cast<float>(CapsuleComponent->GetComponentLocation().Z),
+		          0.01f);
+
+		CapsuleComponent->AddWorldOffset(FVector(10, 0, 0));
+
+		const FMMovementGroundProbeResult& GroundAfterMove = MovementComponent->ProbeGround(GroundProbeDistance);
+		if (!TestTrue(TEXT("Ground after move is hit"), GroundAfterMove.IsGroundWithin(GroundProbeDistance)))
+			return false;
+
+		const FVector SnapLocation = GroundAfterMove.Hit.ImpactPoint + FVector::UpVector * GroundSnapOffset;
+		const FVector SnapDelta = SnapLocation - CapsuleComponent->GetComponentLocation();
+		CapsuleComponent->AddWorldOffset(SnapDelta * GroundSnapSpeed * DeltaTime);
+
+		// First frame traces before and after the move, later frames reuse the last post-move probe before the move
+		const uint32 FrameTraceCount = MovementComponent->GetGroundProbeTraceCount() - TraceCountBefore;
+		TestEqual(FString::Printf(TEXT("Ground probe traces in frame %d"), Frame), FrameTraceCount, Frame == 0 ? 2u : 1u);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,142 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#include "MMovementSurfaceSensor.h"
+#include "MMovementTestWorld.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MMovementSurfaceSensorTests
+{
+	constexpr float DeltaTime = 1.f / 60.f;
+
+	// Wall with its face on plane Y = WallPlaneY, facing -Y
+	constexpr float WallPlaneY = 100.f;
+
+	void SpawnWall(const FMMovementTestWorld& TestWorld)
+	{
+		TestWorld.SpawnBox(FVector(0, WallPlaneY + 50.f, 0), FVector(5000, 50, 1000));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMMovementSurfaceSensorAsyncCorrectionTest, "MMovement.SurfaceSensor.AsyncHitCorrection",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMMovementSurfaceSensorAsyncCorrectionTest::RunTest(const FString& Parameters)
+{
+	using namespace MMovementSurfaceSensorTests;
+
+	FMMovementTestWorld TestWorld;
+	SpawnWall(TestWorld);
+
+	const FMMovementQueryConfig QueryConfig;
+	const FCollisionShape CollisionShape = FCollisionShape::MakeSphere(20.f);
+	const FCollisionQueryParams QueryParams;
+	const FVector SweepDelta = FVector(0, 200, 0);
+
+	FMMovementSurfaceSensor SurfaceSensor;
+	const FVector PredictedStart = FVector::ZeroVector;
+	SurfaceSensor.RequestAsyncSweep(TestWorld.GetWorld(), PredictedStart, PredictedStart + SweepDelta, QueryConfig, CollisionShape,
+	                                QueryParams);
+	TestWorld.Tick(DeltaTime);
+
+	// Character ended up closer to the wall and further along it than predicted
+	const FVector ActualStart = PredictedStart + FVector(10, 15, 0);
+
+	TArray<FHitResult> Hits;
+	if (!TestTrue(TEXT("Async sweep is consumed"), SurfaceSensor.ConsumeAsyncSweep(TestWorld.GetWorld(), ActualStart, 50.f, Hits)))
+		return false;
+
+	if (!TestTrue(TEXT("Wall is hit"), Hits.Num() > 0))
+		return false;
+
+	for (const FHitResult& Hit : Hits)
+	{
+		TestEqual(TEXT("Trace start is the actual start"), Hit.TraceStart, ActualStart, 0.01f);
+		TestEqual(TEXT("Impact point stays on the wall plane"), Hit.ImpactPoint.Y, WallPlaneY, 0.1f);
+		TestEqual(TEXT("Shape location keeps its distance from the wall"), Hit.Location.Y, WallPlaneY - CollisionShape.GetSphereRadius(),
+		          0.1f);
+	}
+
+	// Start further from the prediction than allowed has to fall back to sync sweep
+	SurfaceSensor.RequestAsyncSweep(TestWorld.GetWorld(), PredictedStart, PredictedStart + SweepDelta, QueryConfig, CollisionShape,
+	                                QueryParams);
+	TestWorld.Tick(DeltaTime);
+	TestFalse(TEXT("Async sweep beyond max prediction error is rejected"),
+	          SurfaceSensor.ConsumeAsyncSweep(TestWorld.GetWorld(), PredictedStart + FVector(100, 0, 0), 50.f, Hits));
+
+	return true;
+}
+
+/**
+ * Game thread cost of sync sensing against async request + consume on the same wall
+ * Run with Automation RunTests MMovement.SurfaceSensor.SyncVsAsyncBenchmark, results are reported as test info
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMMovementSurfaceSensorBenchmarkTest, "MMovement.SurfaceSensor.SyncVsAsyncBenchmark",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FMMovementSurfaceSensorBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace MMovementSurfaceSensorTests;
+
+	constexpr int32 NumFrames = 1000;
+	constexpr float Speed = 600.f;
+
+	FMMovementTestWorld TestWorld;
+	SpawnWall(TestWorld);
+
+	const FMMovementQueryConfig QueryConfig;
+	const FCollisionShape CollisionShape = FCollisionShape::MakeCapsule(40.f, 90.f);
+	const FCollisionQueryParams QueryParams;
+	const FVector SweepDelta = FVector(0, 100, 0);
+	const FVector FrameDelta = FVector(Speed * DeltaTime, 0, 0);
+
+	TArray<FHitResult> Hits;
+
+	uint64 SyncCycles = 0;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const FVector Start = FrameDelta * Frame;
+
+		const uint64 CyclesStart = FPlatformTime::Cycles64();
+		FMMovementSurfaceSensor::SweepSync(TestWorld.GetWorld(), Start, Start + SweepDelta, QueryConfig, CollisionShape, QueryParams, Hits);
+		SyncCycles += FPlatformTime::Cycles64() - CyclesStart;
+
+		TestWorld.Tick(DeltaTime);
+	}
+
+	FMMovementSurfaceSensor SurfaceSensor;
+	uint64 AsyncCycles = 0;
+	int32 NumFallbacks = 0;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const FVector Start = FrameDelta * Frame;
+
+		const uint64 CyclesStart = FPlatformTime::Cycles64();
+		if (!SurfaceSensor.ConsumeAsyncSweep(TestWorld.GetWorld(), Start, 50.f, Hits))
+		{
+			FMMovementSurfaceSensor::SweepSync(TestWorld.GetWorld(), Start, Start + SweepDelta, QueryConfig, CollisionShape, QueryParams,
+			                                   Hits);
+			++NumFallbacks;
+		}
+
+		const FVector PredictedStart = Start + FrameDelta;
+		SurfaceSensor.RequestAsyncSweep(TestWorld.GetWorld(), PredictedStart, PredictedStart + SweepDelta, QueryConfig, CollisionShape,
+		                                QueryParams);
+		AsyncCycles += FPlatformTime::Cycles64() - CyclesStart;
+
+		TestWorld.Tick(DeltaTime);
+	}
+
+	const double SyncMicroseconds = FPlatformTime::ToSeconds64(SyncCycles) * 1e6 / NumFrames;
+	const double AsyncMicroseconds = FPlatformTime::ToSeconds64(AsyncCycles) * 1e6 / NumFrames;
+	AddInfo(FString::Printf(TEXT("Sync: %.2f us per frame, Async (request + consume): %.2f us per frame, %d fallbacks in %d frames"),
+	                        SyncMicroseconds, AsyncMicroseconds, NumFallbacks, NumFrames));
+
+	// Only the first frame has nothing to consume
+	TestEqual(TEXT("Async fallbacks"), NumFallbacks, 1);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,67 @@
+// Copyright (c) Miknios. All rights reserved.
+
+
+#include "MMovementTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/CollisionProfile.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Components/StaticMeshComponent.h"
+
+FMMovementTestWorld::FMMovementTestWorld()
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("MMovementTestWorld"));
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitializeActorsForPlay(FURL());
+}
+
+FMMovementTestWorld::~FMMovementTestWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+}
+
+AStaticMeshActor* FMMovementTestWorld::SpawnBox(const FVector& Location, const FVector& HalfExtent, const FRotator& Rotation,
+                                                const EComponentMobility::Type Mobility) const
+{
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (CubeMesh == nullptr)
+		return nullptr;
+
+	AStaticMeshActor* BoxActor = World->SpawnActor<AStaticMeshActor>(Location, Rotation);
+	UStaticMeshComponent* MeshComponent = BoxActor->GetStaticMeshComponent();
+
+	// Static mesh can't be changed on static components at runtime
+	MeshComponent->SetMobility(EComponentMobility::Movable);
+	MeshComponent->SetStaticMesh(CubeMesh);
+	MeshComponent->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+
+	// Engine cube is 100 units wide
+	BoxActor->SetActorScale3D(HalfExtent / 50.f);
+
+	MeshComponent->SetMobility(Mobility);
+
+	return BoxActor;
+}
+
+void FMMovementTestWorld::BeginPlay() const
+{
+	World->BeginPlay();
+}
+
+void FMMovementTestWorld::Tick(const float DeltaTime) const
+{
+	World->Tick(LEVELTICK_All, DeltaTime);
+
+	// Traces kicked off at the end of the tick are consumed right after it in tests
+	World->WaitForAllAsyncTraceTasks();
+}
+
+#endif
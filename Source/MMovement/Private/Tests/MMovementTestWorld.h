@@ -0,0 +1,39 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class AStaticMeshActor;
+
+/**
+ * Transient game world for automation tests, destroyed with this object
+ * Play is not begun until BeginPlay is called, until then spawned actors and components don't run BeginPlay and don't tick
+ */
+struct FMMovementTestWorld
+{
+	FMMovementTestWorld();
+	~FMMovementTestWorld();
+
+	FMMovementTestWorld(const FMMovementTestWorld&) = delete;
+	FMMovementTestWorld& operator=(const FMMovementTestWorld&) = delete;
+
+	UWorld* GetWorld() const { return World; }
+
+	// Engine cube scaled to HalfExtent, blocking all channels
+	AStaticMeshActor* SpawnBox(const FVector& Location, const FVector& HalfExtent, const FRotator& Rotation = FRotator::ZeroRotator,
+	                           EComponentMobility::Type Mobility = EComponentMobility::Movable) const;
+
+	// Begins play, needed by world subsystems working only in play like the traversal index
+	void BeginPlay() const;
+
+	// Ticks the world and waits for async traces requested before the tick, their results can be queried until the next tick
+	void Tick(float DeltaTime) const;
+
+private:
+	UWorld* World = nullptr;
+};
+
+#endif
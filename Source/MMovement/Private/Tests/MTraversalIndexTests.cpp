@@ -0,0 +1,88 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#include "MMovementSurfaceSubsystem.h"
+#include "MMovementTestWorld.h"
+#include "MTraversalIndexSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace MTraversalIndexTests
+{
+	const FName SlidableCategory = TEXT("Slidable");
+	const FName NoSlideCategory = TEXT("NoSlide");
+
+	UPrimitiveComponent* SpawnSurface(const FMMovementTestWorld& TestWorld, const FVector& Location, const FVector& HalfExtent,
+	                                  const FName Category)
+	{
+		const AStaticMeshActor* BoxActor = TestWorld.SpawnBox(Location, HalfExtent, FRotator::ZeroRotator, EComponentMobility::Static);
+		if (BoxActor == nullptr)
+			return nullptr;
+
+		UStaticMeshComponent* MeshComponent = BoxActor->GetStaticMeshComponent();
+		MeshComponent->ComponentTags.Add(Category);
+		return MeshComponent;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMTraversalIndexFilteredOcclusionTest, "MMovement.TraversalIndex.FilteredSurfaceOcclusion",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FMTraversalIndexFilteredOcclusionTest::RunTest(const FString& Parameters)
+{
+	using namespace MTraversalIndexTests;
+
+	FMMovementTestWorld TestWorld;
+
+	// Slidable floor with its top on Z = 0, non slidable floor above a part of it with its top on Z = 100
+	const UPrimitiveComponent* SlidableFloor = SpawnSurface(TestWorld, FVector(0, 0, -50), FVector(1000, 1000, 50), SlidableCategory);
+	SpawnSurface(TestWorld, FVector(0, 0, 90), FVector(200, 200, 10), NoSlideCategory);
+
+	// Non slidable wall with its face on Y = 100 in front of slidable wall with its face on Y = 200
+	const float WallsX = 3000;
+	SpawnSurface(TestWorld, FVector(WallsX, 110, 0), FVector(200, 10, 200), NoSlideCategory);
+	SpawnSurface(TestWorld, FVector(WallsX, 250, 0), FVector(200, 50, 200), SlidableCategory);
+
+	if (!TestNotNull(TEXT("Slidable floor is spawned"), SlidableFloor))
+		return false;
+
+	UWorld* World = TestWorld.GetWorld();
+	UMTraversalIndexSubsystem* TraversalIndexSubsystem = World->GetSubsystem<UMTraversalIndexSubsystem>();
+	if (!TestNotNull(TEXT("Traversal index exists in game world"), TraversalIndexSubsystem))
+		return false;
+
+	// Slide like filter, requires slidable surface and rejects surface excluded from sliding
+	const TArray<FName> ExcludedCategories = {NoSlideCategory};
+	FMMovementSurfaceFilter SurfaceFilter;
+	SurfaceFilter.Compile(World->GetSubsystem<UMMovementSurfaceSubsystem>(), SlidableCategory, ExcludedCategories);
+	TestTrue(TEXT("Filter is registered"), TraversalIndexSubsystem->RegisterSurfaceFilter(SurfaceFilter));
+
+	TestWorld.BeginPlay();
+
+	// Down trace over the non slidable floor stops on it instead of reaching the slidable floor below
+	bool bHit = false;
+	FHitResult Hit;
+	TestTrue(TEXT("Trace over non slidable floor is served"),
+	         TraversalIndexSubsystem->LineTrace(FVector(0, 0, 300), FVector(0, 0, -200), SurfaceFilter, bHit, Hit));
+	TestFalse(TEXT("Slidable floor below non slidable floor is occluded"), bHit);
+
+	// Down trace next to the non slidable floor reaches the slidable floor
+	TestTrue(TEXT("Trace over slidable floor is served"),
+	         TraversalIndexSubsystem->LineTrace(FVector(500, 0, 300), FVector(500, 0, -200), SurfaceFilter, bHit, Hit));
+	TestTrue(TEXT("Slidable floor is hit"), bHit && Hit.GetComponent() == SlidableFloor);
+	TestEqual(TEXT("Slidable floor impact point"), Hit.ImpactPoint.Z, 0.0, 0.1);
+
+	// Capsule sweep toward the walls stops on the non slidable wall and doesn't report the slidable wall behind it
+	TArray<FHitResult> Hits;
+	const FVector SweepStart(WallsX, -100, 0);
+	TestTrue(TEXT("Sweep is served"),
+	         TraversalIndexSubsystem->QueryCapsule(SweepStart, SweepStart + FVector(0, 300, 0), 30.f, 90.f, SurfaceFilter, Hits));
+	TestEqual(TEXT("Slidable wall behind non slidable wall is occluded"), Hits.Num(), 0);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,48 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MBakedCurve.generated.h"
+
+class UCurveFloat;
+
+/**
+ * Float curve baked into uniformly sampled table over the curve time range
+ * Evaluation is clamped to the time range and is an indexed lerp instead of rich curve key search
+ */
+USTRUCT(BlueprintType)
+struct MMOVEMENT_API FMBakedCurve
+{
+	GENERATED_BODY()
+
+	static constexpr int32 DefaultSampleCount = 64;
+
+	// Samples the curve, table is cleared if curve is null
+	void Bake(const UCurveFloat* Curve, int32 SampleCount = DefaultSampleCount);
+
+	bool IsBaked() const { return Samples.Num() > 0; }
+
+	float Evaluate(const float Time) const
+	{
+		const int32 SampleCount = Samples.Num();
+		if (SampleCount < 2)
+			return SampleCount == 1 ? Samples[0] : 0;
+
+		const float SamplePosition = FMath::Clamp((Time - TimeMin) * SamplesPerSecond, 0.f, static_cast<float>(SampleCount - 1));
+		const int32 SampleIndex = FMath::Min(FMath::FloorToInt32(SamplePosition), SampleCount - 2);
+
+		return FMath::Lerp(Samples[SampleIndex], Samples[SampleIndex + 1], SamplePosition - SampleIndex);
+	}
+
+protected:
+	UPROPERTY(VisibleAnywhere)
+	TArray<float> Samples;
+
+	UPROPERTY(VisibleAnywhere)
+	float TimeMin = 0;
+
+	// Inverse of time between samples
+	UPROPERTY(VisibleAnywhere)
+	float SamplesPerSecond = 0;
+};
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "MCharacterMovementWalkingSpeed.h"
+#include "MMovementGroundProbe.h"
+#include "MMovementQueryConfig.h"
+#include "MMovementSignalHistory.h"
+#include "MMovementTypes.h"
 #include "MResettable.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "VisualLogger/VisualLoggerDebugSnapshotInterface.h"
@@ -30,6 +34,20 @@ struct FMCharacterMovementComponent_DefaultValues
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMOnJumpedSignature);
 
+// Movement state predicates cached by MCharacterMovementComponent, each value bit is valid only with its resolved bit
+enum class EMMovementStateCacheFlags : uint8
+{
+	None = 0,
+	MovingOnSurfaceResolved = 1 << 0,
+	MovingOnSurface = 1 << 1,
+	MovingOnGroundResolved = 1 << 2,
+	MovingOnGround = 1 << 3,
+	CanCrouchResolved = 1 << 4,
+	CanCrouch = 1 << 5,
+};
+
+ENUM_CLASS_FLAGS(EMMovementStateCacheFlags);
+
 /**
  * Base class for CMC that can use custom movement modes and some other features
  */
@@ -45,6 +63,7 @@ public:
 
 	// ~ UActorComponent
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	// ~ UActorComponent
 
@@ -76,15 +95,36 @@ public:
 	UPrimitiveComponent* GetMovementBaseCustom() const;
 
 	UFUNCTION(BlueprintCallable)
-	void AddControlledLaunchFromParams(const FVector& LaunchVelocity, const FMControlledLaunchParams& LaunchParams,
-	                                   UObject* Owner = nullptr);
+	FMControlledLaunchHandle AddControlledLaunchFromParams(const FVector& LaunchVelocity, const FMControlledLaunchParams& LaunchParams,
+	                                                       UObject* Owner = nullptr);
+
+	UFUNCTION(BlueprintCallable)
+	FMControlledLaunchHandle AddControlledLaunchFromAsset(const FVector& LaunchVelocity, const UMControlledLaunchAsset* LaunchAsset,
+	                                                      UObject* Owner = nullptr);
+
+	UFUNCTION(BlueprintCallable)
+	bool CancelControlledLaunch(FMControlledLaunchHandle Handle);
 
 	UFUNCTION(BlueprintCallable)
-	void AddControlledLaunchFromAsset(const FVector& LaunchVelocity, const UMControlledLaunchAsset* LaunchAsset, UObject* Owner = nullptr);
+	bool IsControlledLaunchActive(FMControlledLaunchHandle Handle) const;
 
+	// Instance of the movement mode class, or of the first (in priority order) mode deriving from it
 	UFUNCTION(BlueprintCallable)
 	UMMovementMode_Base* GetCustomMovementModeInstance(TSubclassOf<UMMovementMode_Base> MovementModeClass) const;
 
+	// Bits of registry slots of MovementModeClass instances (including subclasses)
+	uint64 GetMovementModeMask(TSubclassOf<UMMovementMode_Base> MovementModeClass) const;
+
+	// Bit of the active custom movement mode, 0 when no custom movement mode is active
+	uint64 GetActiveMovementModeMask() const;
+
+	template <typename T>
+	T* GetMode() const
+	{
+		// Registry only maps classes to instances of them or their subclasses
+		return static_cast<T*>(GetCustomMovementModeInstance(T::StaticClass()));
+	}
+
 	UFUNCTION(BlueprintCallable)
 	UMControlledLaunchManager* GetControlledLaunchManager() const { return ControlledLaunchManager; }
 
@@ -94,15 +134,57 @@ public:
 	UFUNCTION(BlueprintCallable)
 	FVector GetPeakTemporalHorizontalVelocity() const;
 
+	// Highest value of the signal within SignalHistoryDuration
+	UFUNCTION(BlueprintCallable)
+	float GetPeakTemporalSignalValue(EMMovementSignal Signal) const;
+
 	UFUNCTION(BlueprintCallable)
 	bool IsMovingOnSurface() const;
 
+	/**
+	 * IsFalling, IsMovingOnGround, IsMovingOnSurface and CanCrouchInCurrentState are resolved once per substep and movement mode change
+	 * Call this when the answer of the active movement mode changes in between
+	 */
+	UFUNCTION(BlueprintCallable)
+	void InvalidateMovementStateCache() { MovementStateCache = EMMovementStateCacheFlags::None; }
+
+	// Resumes MMovement work if the component sleeps and restarts counting of idle frames
+	UFUNCTION(BlueprintCallable)
+	void WakeMovement();
+
+	UFUNCTION(BlueprintCallable)
+	bool IsMovementSleeping() const { return bMovementSleeping; }
+
 	UFUNCTION(BlueprintCallable)
 	void ClearTemporalHorizontalVelocity();
 
 	UFUNCTION(BlueprintCallable)
 	FVector GetDirectionAlongFloorForDirection(const FVector& Direction) const;
 
+	/**
+	 * Ground below the character within MaxDistance from updated component location
+	 * Reuses CurrentFloor when walking, otherwise traces once to the furthest registered distance and serves
+	 * queries from that trace in this and the next frame while the location stays on the traced segment
+	 * (e.g., post-move probe answers the next frame after snapping down to the ground)
+	 */
+	const FMMovementGroundProbeResult& ProbeGround(float MaxDistance) const;
+
+	// Ground probe traces done by this component, counted like STAT_MMovement_GroundProbeTraces but without stats enabled
+	uint32 GetGroundProbeTraceCount() const { return GroundProbeTraceCount; }
+
+	// Movement modes register the furthest distance they will probe for, so a single trace covers all of them
+	void RegisterGroundProbeDistance(float MaxDistance);
+
+	/**
+	 * Moves by Delta with the surface snap folded into the same sweep, for modes attached to a surface
+	 * CalculateSnapDelta returns snap correction for a location, it's evaluated at the location expected after the move
+	 * When the combined sweep is blocked, it's reverted and the regular two step move is performed instead:
+	 * swept move with slide along the hit surface, then a separate snap sweep evaluated at the reached location
+	 * Returns false when the two step fallback was used, OutHit is the hit of the move then
+	 */
+	bool SafeMoveUpdatedComponentWithSnap(const FVector& Delta, float DeltaTime, TFunctionRef<FVector(const FVector& Location)> CalculateSnapDelta,
+	                                      FHitResult& OutHit);
+
 	// Last movement direction input vector
 	UFUNCTION(BlueprintCallable)
 	FVector GetMovementInputVectorLast() const { return MovementInputVectorLast; }
@@ -152,14 +234,30 @@ protected:
 	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
 	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
 	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+	virtual void StartNewPhysics(float deltaTime, int32 Iterations) override;
 	virtual bool CanCrouchInCurrentState() const override;
 	virtual bool IsWalkable(const FHitResult& Hit) const override;
 	virtual FVector ScaleInputAcceleration(const FVector& InputAcceleration) const override;
 	// ~ UCharacterMovementComponent
 
-	void UpdateTemporalHorizontalVelocityEntry();
+	void InitializeSignalHistories();
+	void UpdateSignalHistories();
 	UMMovementMode_Base* GetCustomMovementModeInstanceForEnum(uint8 EnumValue) const;
 
+	// Uncached movement state predicates, called through the movement state cache
+	bool ResolveIsMovingOnSurface() const;
+	bool ResolveIsMovingOnGround() const;
+	bool ResolveCanCrouchInCurrentState() const;
+
+	bool GetCachedMovementState(EMMovementStateCacheFlags ResolvedFlag, EMMovementStateCacheFlags ValueFlag,
+	                            bool (UMCharacterMovementComponent::*Resolve)() const) const;
+
+	// Maps mode classes (and their parents) to instances and assigns custom movement mode bytes to instances
+	void BuildMovementModeRegistry();
+
+	// Compiles transition configs of movement modes into interrupt and cooldown link masks
+	void BuildMovementModeTransitionMatrix();
+
 	/**
 	 * Override for custom character orientation logic (rotate to aim in top-down, rotate to velocity instead of acceleration etc.)
 	 * This is skipped if the current movement mode implements IMMovementMode_OrientToMovementInterface
@@ -168,6 +266,21 @@ protected:
 
 	void ApplyWalkingSpeedConfig(const FMCharacterMovementWalkingSpeedConfig& Config);
 
+	// Assigns dense indices to speed types from SpeedConfigForSpeedTypeMap and copies their configs to a flat table
+	void BuildSpeedConfigTable();
+	int32 GetSpeedTypeIndex(const UMCharacterMovementWalkingSpeedTypeAsset* SpeedTypeAsset) const;
+
+	// Refreshes SpeedConfigResolved from current speed type
+	void ResolveCurrentSpeedConfig();
+
+	// Counts idle frames and puts the component to sleep or wakes it up
+	void UpdateMovementSleep();
+
+	// No custom movement mode, input, velocity, pending launch or impulse and no controlled launch
+	bool IsIdleFrame() const;
+
+	bool CanMovementModesSleep() const;
+
 protected:
 	UPROPERTY(EditAnywhere, Category = "Movement|Speed")
 	TObjectPtr<UMCharacterMovementWalkingSpeedTypeAsset> SpeedTypeInitial;
@@ -178,25 +291,69 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Movement|Movement Modes")
 	TArray<TSubclassOf<UMMovementMode_Base>> AvailableMovementModes;
 
-	// How many frames are included to get Temporal Peak Horizontal Velocity
+	// How many seconds of history are included to get Temporal Peak Horizontal Velocity and other signal peaks
+	UPROPERTY(EditAnywhere, Category = "Movement|Modes", meta = (ClampMin = 0, Units = "Seconds"))
+	float SignalHistoryDuration = 0.05f;
+
+	// Highest expected tick rate, used to size signal histories. When exceeded, oldest samples in the window are dropped
+	UPROPERTY(EditAnywhere, Category = "Movement|Modes", AdvancedDisplay, meta = (ClampMin = 1))
+	float SignalHistoryMaxSampleRate = 240;
+
+	// What ground probe shared by movement modes (ProbeGround) collides with
 	UPROPERTY(EditAnywhere, Category = "Movement|Modes")
-	float TemporalPeakHorizontalVelocityHistoryFramesAmount = 3;
+	FMMovementQueryConfig GroundProbeQueryConfig;
 
 	UPROPERTY(Transient, VisibleInstanceOnly, Category = "Movement|Modes")
 	TArray<UMMovementMode_Base*> CustomMovementModeInstances;
 
+	// Mode class (and each of its parent classes) to the first instance in CustomMovementModeInstances of that class
+	TMap<const UClass*, UMMovementMode_Base*> MovementModeRegistry;
+
+	// Instance for each custom movement mode byte, nullptr for unassigned bytes
+	TArray<UMMovementMode_Base*> CustomMovementModeInstancesByByte;
+
+	// Movement modes are identified by bits of uint64 masks
+	static constexpr int32 MaxCustomMovementModes = 64;
+
+	// Per registry slot: modes the mode in the slot is allowed to interrupt
+	TArray<uint64> MovementModeInterruptMasks;
+
+	// Per registry slot: modes whose cooldown is activated when the mode in the slot ends
+	TArray<uint64> MovementModeCooldownLinkMasks;
+
 	UPROPERTY(Transient, VisibleAnywhere, Category = "Movement|Controlled Launch")
 	TObjectPtr<UMControlledLaunchManager> ControlledLaunchManager;
 
+	// Tick controlled launches in UMControlledLaunchSubsystem batch together with other characters instead of in this component tick
+	UPROPERTY(EditAnywhere, Category = "Movement|Controlled Launch")
+	bool bTickControlledLaunchesInSubsystem = false;
+
+	// Skip input caching, controlled launches, signal histories and movement mode ticks of characters standing still
+	UPROPERTY(EditAnywhere, Category = "Movement|Idle Sleep")
+	bool bSleepWhenIdle = true;
+
+	// How many idle frames in a row put the component to sleep
+	UPROPERTY(EditAnywhere, Category = "Movement|Idle Sleep", meta = (ClampMin = 1, EditCondition = "bSleepWhenIdle"))
+	int32 IdleFramesToSleep = 30;
+
 	UPROPERTY(Transient, VisibleInstanceOnly, Category = "Movement|Speed")
 	TObjectPtr<UMCharacterMovementWalkingSpeedTypeAsset> SpeedTypeCurrent;
 
+	// Config of current speed type, used in hot paths (GetMaxSpeed, braking) instead of map lookups
+	UPROPERTY(Transient, VisibleInstanceOnly, Category = "Movement|Speed")
+	FMCharacterMovementWalkingSpeedConfig SpeedConfigResolved;
+
+	// Speed types by dense index, built from SpeedConfigForSpeedTypeMap
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMCharacterMovementWalkingSpeedTypeAsset>> SpeedTypeTable;
+
+	// Configs by speed type index
+	UPROPERTY(Transient)
+	TArray<FMCharacterMovementWalkingSpeedConfig> SpeedConfigTable;
+
 	UPROPERTY(Transient, VisibleInstanceOnly, Category = "Movement")
 	FMCharacterMovementComponent_DefaultValues DefaultValues;
 
-	UPROPERTY(Transient, VisibleAnywhere, Category = "Movement")
-	TArray<FVector> TemporalHorizontalVelocityArray;
-
 	UPROPERTY(Transient, VisibleInstanceOnly, Category = "Movement")
 	UPrimitiveComponent* CustomMovementBase;
 
@@ -209,4 +366,33 @@ protected:
 	FVector MovementInputVectorActiveLast;
 
 	bool bMovementModesInitialized;
+
+	// Missing speed type config is reported once instead of on every query
+	mutable bool bSpeedConfigErrorReported = false;
+
+	FMMovementSignalHistory SignalHistories[static_cast<uint8>(EMMovementSignal::MAX)];
+
+	// Used to detect falling transition for movement mode wake conditions
+	bool bWasFallingLastMovementUpdate = false;
+
+	mutable EMMovementStateCacheFlags MovementStateCache = EMMovementStateCacheFlags::None;
+
+	bool bMovementSleeping = false;
+	int32 IdleFrameCount = 0;
+
+	// Movement base when the component went to sleep, only compared against. Its motion wakes the component up
+	const UPrimitiveComponent* SleepMovementBase = nullptr;
+	FTransform SleepMovementBaseTransform = FTransform::Identity;
+
+	// Furthest distance registered by movement modes, ground probe traces always this far
+	float GroundProbeDistance = 0;
+
+	FCollisionQueryParams GroundProbeQueryParams;
+
+	// Ground probe memo, valid below GroundProbeLocation up to GroundProbeTracedDistance until the frame after GroundProbeFrame
+	mutable FMMovementGroundProbeResult GroundProbeResult;
+	mutable FVector GroundProbeLocation = FVector::ZeroVector;
+	mutable uint64 GroundProbeFrame = MAX_uint64;
+	mutable float GroundProbeTracedDistance = 0;
+	mutable uint32 GroundProbeTraceCount = 0;
 };
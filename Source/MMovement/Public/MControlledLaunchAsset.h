@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MBakedCurve.h"
 #include "Engine/DataAsset.h"
 #include "MControlledLaunchAsset.generated.h"
 
@@ -55,6 +56,26 @@ struct MMOVEMENT_API FMControlledLaunchParams
 	// Disable launch when horizontal speed in launch direction is below 300
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bDisableOnSpeedInHorizontalLaunchDirectionBelowThreshold = true;
+
+	// Curves baked for runtime evaluation, filled by BakeCurves
+	UPROPERTY(Transient)
+	FMBakedCurve AccelerationMultiplierCurveBaked;
+
+	UPROPERTY(Transient)
+	FMBakedCurve BrakingDecelerationMultiplierCurveBaked;
+
+	UPROPERTY(Transient)
+	FMBakedCurve GravityMultiplierCurveBaked;
+
+	UPROPERTY(Transient)
+	bool bCurvesBaked = false;
+
+	// False if any curve of influenced value is missing
+	UPROPERTY(Transient)
+	bool bCurvesValid = false;
+
+	// Bakes curves and validates them. Returns false if curve of any influenced value is null
+	bool BakeCurves();
 };
 
 UCLASS()
@@ -62,7 +83,18 @@ class MMOVEMENT_API UMControlledLaunchAsset : public UPrimaryDataAsset
 {
 	GENERATED_BODY()
 
+public:
+	// ~ UObject
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	// ~ UObject
+
 public:
 	UPROPERTY(EditAnywhere, meta = (ShowOnlyInnerProperties))
 	FMControlledLaunchParams LaunchParams;
+
+protected:
+	void BakeLaunchParams();
 };
@@ -6,7 +6,9 @@
 #include "MCharacterMovementComponent.h"
 #include "MControlledLaunchAsset.h"
 #include "MManualTimer.h"
+#include "MMovementTypes.h"
 #include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
 #include "MControlledLaunchManager.generated.h"
 
 class UMCharacterMovementComponent;
@@ -40,6 +42,14 @@ struct FMControlledLaunchManager_ProcessResult
 	}
 };
 
+// Multipliers of a single launch instance at its current timer progress
+struct FMControlledLaunchManager_InstanceMultipliers
+{
+	float Acceleration = 1;
+	float BrakingDeceleration = 1;
+	float Gravity = 1;
+};
+
 USTRUCT(BlueprintType)
 struct FMControlledLaunchManager_LaunchInstance
 {
@@ -51,23 +61,80 @@ struct FMControlledLaunchManager_LaunchInstance
 	UPROPERTY(VisibleAnywhere)
 	FMManualTimer WalkingBlockTimer = FMManualTimer();
 
+	// Asset the params are read from, null if launch was added from params
 	UPROPERTY(VisibleAnywhere)
-	FMControlledLaunchParams LaunchParams = FMControlledLaunchParams();
+	TObjectPtr<const UMControlledLaunchAsset> LaunchAsset = nullptr;
+
+	// Params of launch added from params instead of asset. Shared, so moving instances in the pool doesn't copy them
+	TSharedPtr<const FMControlledLaunchParams> InlineLaunchParams;
 
 	UPROPERTY(VisibleAnywhere)
 	FVector LaunchVelocity = FVector::ZeroVector;
 
+	// Owner this launch was added for. Doesn't keep the owner alive and stays unique after it's garbage collected
+	TObjectKey<UObject> OwnerKey;
+
+	// Slot of the handle pointing to this instance
+	int32 SlotIndex = INDEX_NONE;
+
 	FMControlledLaunchManager_LaunchInstance() = default;
 
 	FMControlledLaunchManager_LaunchInstance(const FMControlledLaunchParams& LaunchParams, const FVector& LaunchVelocity)
 		: DurationTimer(FMManualTimer(LaunchParams.Duration)),
 		  WalkingBlockTimer(FMManualTimer(LaunchParams.WalkingBlockDuration)),
-		  LaunchParams(LaunchParams),
 		  LaunchVelocity(LaunchVelocity)
 	{
 	}
 
+	const FMControlledLaunchParams& GetLaunchParams() const
+	{
+		return LaunchAsset != nullptr ? LaunchAsset->LaunchParams : *InlineLaunchParams;
+	}
+
 	void ProcessAndCombine(FMControlledLaunchManager_ProcessResult& ProcessResult) const;
+
+	// Multipliers depend only on timer progress, 1 if the launch doesn't influence the value
+	float GetAccelerationMultiplier() const;
+	float GetBrakingDecelerationMultiplier() const;
+	float GetGravityMultiplier() const;
+
+	FMControlledLaunchManager_InstanceMultipliers EvaluateMultipliers() const;
+
+	void TickTimers(float DeltaTime);
+};
+
+// Indirection between handles and launch instances, so instances can be stored densely
+struct FMControlledLaunchManager_Slot
+{
+	// Index in dense launch instance array, INDEX_NONE if slot is free
+	int32 InstanceIndex = INDEX_NONE;
+	int32 Generation = 0;
+};
+
+// Acceleration scaling only in horizontal launch direction, used for bAllowFullInputAccelerationPerpendicularToLaunchDirection
+struct FMControlledLaunchManager_AccelerationProjection
+{
+	FVector LaunchDirectionHorizontal = FVector::ZeroVector;
+	float Multiplier = 1;
+};
+
+/**
+ * Multipliers of all active launches combined, computed once per launch state change (tick, add, clear)
+ * Only acceleration projections depend on the acceleration direction, so they are the only part applied per Process call
+ */
+struct FMControlledLaunchManager_ProcessCache
+{
+	// Generation of launch state this cache was computed for
+	uint32 Generation = 0;
+
+	float AccelerationMultiplier = 1;
+	float BrakingDecelerationMultiplier = 1;
+	float GravityMultiplier = 1;
+
+	// Product of acceleration multipliers of launches that scale acceleration uniformly
+	float UniformAccelerationMultiplier = 1;
+
+	TArray<FMControlledLaunchManager_AccelerationProjection> AccelerationProjections;
 };
 
 class UCharacterMovementComponent;
@@ -93,9 +160,41 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void ClearAllLaunches();
 
+	// Removes the launch. Returns false if the handle is stale
+	UFUNCTION(BlueprintCallable)
+	bool CancelControlledLaunch(FMControlledLaunchHandle Handle);
+
+	UFUNCTION(BlueprintCallable)
+	bool IsControlledLaunchActive(FMControlledLaunchHandle Handle) const;
+
 	void Initialize(UMCharacterMovementComponent* InOwnerMovementComponent);
 	void TickLaunches(float DeltaTime);
-	void AddControlledLaunch(const FVector& LaunchVelocity, const FMControlledLaunchParams& LaunchParams, UObject* Owner);
+
+	// Removes finished launches, part of TickLaunches that depends on owner movement state
+	void PruneLaunches();
+
+	/**
+	 * Publishes multipliers evaluated outside the manager (UMControlledLaunchSubsystem batch)
+	 * Expects one entry per active launch instance, in ForEachActiveLaunchInstance order, with instance timers already ticked
+	 */
+	void ApplyBatchedMultipliers(TConstArrayView<FMControlledLaunchManager_InstanceMultipliers> InstanceMultipliers);
+
+	// When ticked by subsystem, owner movement component doesn't tick launches itself
+	void SetTickedBySubsystem(bool bInTickedBySubsystem) { bTickedBySubsystem = bInTickedBySubsystem; }
+	bool IsTickedBySubsystem() const { return bTickedBySubsystem; }
+
+	void ShowDebugs() const;
+
+	// Adds launch with params copied to shared storage. Launch of the same owner is replaced
+	FMControlledLaunchHandle AddControlledLaunch(const FVector& LaunchVelocity, const FMControlledLaunchParams& LaunchParams, UObject* Owner);
+
+	// Adds launch that reads params from asset. Launch of the same owner is replaced
+	FMControlledLaunchHandle AddControlledLaunchFromAsset(const FVector& LaunchVelocity, const UMControlledLaunchAsset* LaunchAsset,
+	                                                      UObject* Owner);
+
+	// Returns nullptr if the handle is stale
+	const FMControlledLaunchManager_LaunchInstance* FindLaunchInstance(FMControlledLaunchHandle Handle) const;
+
 	FMControlledLaunchManager_ProcessResult Process(const FVector& AccelerationCurrent) const;
 
 	// Takes a function to execute for each active controlled launch instance
@@ -108,8 +207,20 @@ public:
 
 protected:
 	void TickLaunchInstance(FMControlledLaunchManager_LaunchInstance& LaunchInstance, float DeltaTime);
+	FMControlledLaunchHandle AddLaunchInstance(FMControlledLaunchManager_LaunchInstance&& LaunchInstance, UObject* Owner);
+	int32 GetInstanceIndex(FMControlledLaunchHandle Handle) const;
+
+	// Swap-and-pop removal, keeps handles of other launches valid
+	void RemoveLaunchInstanceAt(int32 InstanceIndex);
 	bool ShouldRemoveLaunchInstance(const FMControlledLaunchManager_LaunchInstance& LaunchInstance) const;
 
+	// Returns process cache, recomputes it if launch state changed since it was computed
+	const FMControlledLaunchManager_ProcessCache& GetProcessCache() const;
+	void UpdateProcessCache() const;
+	void ResetProcessCache() const;
+	void CombineIntoProcessCache(const FMControlledLaunchManager_LaunchInstance& LaunchInstance,
+	                             const FMControlledLaunchManager_InstanceMultipliers& InstanceMultipliers) const;
+
 protected:
 	UPROPERTY(EditDefaultsOnly)
 	float ControlledLaunchSpeedThreshold = 300;
@@ -117,9 +228,19 @@ protected:
 	UPROPERTY()
 	UMCharacterMovementComponent* OwnerMovementComponent;
 
+	// Active launches stored densely, order is not preserved on removal
 	UPROPERTY()
-	TArray<FMControlledLaunchManager_LaunchInstance> LaunchInstancesWithoutOwner;
+	TArray<FMControlledLaunchManager_LaunchInstance> LaunchInstances;
 
-	UPROPERTY()
-	TMap<UObject*, FMControlledLaunchManager_LaunchInstance> LaunchInstanceForOwner;
+	TArray<FMControlledLaunchManager_Slot> Slots;
+	TArray<int32> FreeSlotIndices;
+
+	TMap<TObjectKey<UObject>, int32> SlotIndexForOwner;
+
+	// Incremented whenever launch instances change, starts at 1 so default cache is stale
+	uint32 LaunchStateGeneration = 1;
+
+	mutable FMControlledLaunchManager_ProcessCache ProcessCache;
+
+	bool bTickedBySubsystem = false;
 };
@@ -0,0 +1,79 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MControlledLaunchManager.h"
+#include "MControlledLaunchSubsystem.generated.h"
+
+class UMControlledLaunchSubsystem;
+
+USTRUCT()
+struct FMControlledLaunchSubsystemTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	UMControlledLaunchSubsystem* Subsystem = nullptr;
+
+	// ~ FTickFunction
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+	                         const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+	// ~ FTickFunction
+};
+
+template <>
+struct TStructOpsTypeTraits<FMControlledLaunchSubsystemTickFunction> : public TStructOpsTypeTraitsBase2<
+		FMControlledLaunchSubsystemTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Ticks controlled launch managers of opted-in movement components as one batch in TG_PrePhysics
+ * Launch instances of all managers are gathered into contiguous arrays, timers and multipliers are evaluated in ParallelFor
+ * and results are published to managers before movement components tick (registered components depend on this tick)
+ */
+UCLASS()
+class MMOVEMENT_API UMControlledLaunchSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ~ UWorldSubsystem
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	// ~ UWorldSubsystem
+
+	// Manager will be ticked by this subsystem. Tick function of the movement component is made dependent on subsystem tick
+	void RegisterMovementComponent(UMCharacterMovementComponent* MovementComponent);
+	void UnregisterMovementComponent(UMCharacterMovementComponent* MovementComponent);
+
+	void TickManagers(float DeltaTime);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void UpdateTickEnabled();
+
+protected:
+	FMControlledLaunchSubsystemTickFunction TickFunction;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMCharacterMovementComponent>> MovementComponents;
+
+	// Batch storage, reused between ticks
+	TArray<FMControlledLaunchManager_LaunchInstance*> BatchInstances;
+	TArray<float> BatchDeltaTimes;
+	TArray<FMControlledLaunchManager_InstanceMultipliers> BatchMultipliers;
+
+	// Range of batch arrays for each manager, ManagerBatchOffsets[i + 1] - ManagerBatchOffsets[i] is instance count
+	TArray<int32> ManagerBatchOffsets;
+	TArray<UMControlledLaunchManager*> BatchManagers;
+};
@@ -0,0 +1,64 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MMovementTypes.h"
+#include "VisualLogger/VisualLogger.h"
+
+// Diagnostics are needed when visual logger records or movement debugs are shown, always false when debug is compiled out
+FORCEINLINE bool ShouldRecordMovementDiagnostics()
+{
+#if MMOVEMENT_ENABLE_DEBUG
+#if ENABLE_VISUAL_LOG
+	if (FVisualLogger::IsRecording())
+		return true;
+#endif
+
+	return ShouldShowMovementDebugs();
+#else
+	return false;
+#endif
+}
+
+enum class EMMovementSurfaceValidationResult : uint8
+{
+	Valid,
+	ComponentAlreadyValidated,
+	MissingRequiredCategory,
+	ExcludedCategory,
+	AssistQueryMissed,
+	SurfaceAngleTooLow,
+	SurfaceAngleTooHigh,
+};
+
+/**
+ * Outcome of validating a single surface hit by a movement mode
+ * Recorded instead of text, text is built only when it's logged
+ */
+struct MMOVEMENT_API FMMovementSurfaceValidationRecord
+{
+	FMMovementSurfaceValidationRecord() = default;
+
+	FMMovementSurfaceValidationRecord(const AActor* InActor, const EMMovementSurfaceValidationResult InResult)
+		: Actor(InActor),
+		  Result(InResult)
+	{
+	}
+
+	FString ToString() const;
+
+	TWeakObjectPtr<const AActor> Actor;
+
+	EMMovementSurfaceValidationResult Result = EMMovementSurfaceValidationResult::Valid;
+
+	// Category the result is about (required or excluded category)
+	FName Category;
+
+	// Measured value and its limit (e.g., surface angle)
+	float Value = 0;
+	float Limit = 0;
+
+	// Angle limits were the wider ones used while the mode is active (e.g., to allow mantle)
+	bool bActiveAngleRange = false;
+};
@@ -0,0 +1,25 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+
+// Ground below the character, shared by all movement modes through UMCharacterMovementComponent::ProbeGround
+struct FMMovementGroundProbeResult
+{
+	bool bHit = false;
+
+	// Vertical distance from updated component location to the ground
+	float Distance = 0;
+
+	// Ground directly below updated component location, Normal is the surface normal
+	FHitResult Hit;
+
+	// Result was derived from CurrentFloor, without any trace
+	bool bFromCurrentFloor = false;
+
+	bool IsGroundWithin(const float MaxDistance) const { return bHit && Distance <= MaxDistance; }
+
+	UPrimitiveComponent* GetComponent() const { return bHit ? Hit.GetComponent() : nullptr; }
+};
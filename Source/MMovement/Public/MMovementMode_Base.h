@@ -3,6 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MManualTimer.h"
+#include "MMovementTypes.h"
 #include "MResettable.h"
 #include "UObject/Object.h"
 #include "VisualLogger/VisualLoggerDebugSnapshotInterface.h"
@@ -15,7 +17,71 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMOnMovementModeUpdateSignature);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FMOnMovementModeEndSignature);
 
 enum EMCustomMovementMode : uint8;
+enum class EMMovementSurfaceFilterResult : uint8;
 class UMCharacterMovementComponent;
+class UMMovementMode_Base;
+class UMMovementSurfaceSubsystem;
+class UMTraversalIndexSubsystem;
+class UMTraversalFieldSubsystem;
+struct FMMovementSurfaceFilter;
+class IMMovementMode_OrientToMovementInterface;
+
+// Movement mode events called by MCharacterMovementComponent
+enum class EMMovementModeEvent : uint16
+{
+	None = 0,
+	Tick = 1 << 0,
+	CanStart = 1 << 1,
+	Start = 1 << 2,
+	Phys = 1 << 3,
+	End = 1 << 4,
+	CanCrouch = 1 << 5,
+	IsMovingOnGround = 1 << 6,
+	IsMovingOnSurface = 1 << 7,
+	IsUsingCustomMovementBase = 1 << 8,
+	ComputeOrientToMovementRotation = 1 << 9,
+	All = (1 << 10) - 1
+};
+
+ENUM_CLASS_FLAGS(EMMovementModeEvent);
+
+/**
+ * Capabilities of a movement mode instance resolved once when movement modes are initialized
+ * Events that are not overridden in script are called through their native _Implementation, skipping ProcessEvent
+ */
+struct FMMovementMode_DispatchTable
+{
+	// Events overridden in Blueprint (these still have to go through ProcessEvent)
+	// Everything goes through script until the table is built
+	EMMovementModeEvent ScriptEvents = EMMovementModeEvent::All;
+
+	bool bImplementsOrientToMovementInterface = false;
+
+	// Null when the interface is implemented only in Blueprint
+	IMMovementMode_OrientToMovementInterface* OrientToMovementInterfaceNative = nullptr;
+
+	bool IsScriptEvent(const EMMovementModeEvent Event) const { return EnumHasAnyFlags(ScriptEvents, Event); }
+};
+
+// How a movement mode relates to other movement modes, compiled into mode masks when movement modes are initialized
+USTRUCT(BlueprintType)
+struct FMMovementModeTransitionConfig
+{
+	GENERATED_BODY()
+
+	// Active modes (including their subclasses) this mode can't interrupt
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	TArray<TSubclassOf<UMMovementMode_Base>> CannotInterrupt;
+
+	// This mode can't interrupt active modes with higher priority
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	int32 InterruptPriority = 0;
+
+	// Modes (including their subclasses) whose cooldown is activated when this mode ends
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	TArray<TSubclassOf<UMMovementMode_Base>> ActivateCooldownOnEnd;
+};
+
 /**
  * 
  */
@@ -43,7 +109,7 @@ public:
 
 	// Movement mode is started if this returns true
 	UFUNCTION(BlueprintNativeEvent)
-	bool CanStart(FString& OutFailReason);
+	bool CanStart(FMMovementMode_FailReason& OutFailReason);
 
 	// Called when this movement mode goes active
 	UFUNCTION(BlueprintNativeEvent)
@@ -75,16 +141,84 @@ public:
 	UFUNCTION(BlueprintCallable)
 	FName GetMovementModeName() const;
 
+	// Resolves which events are overridden in script and which interfaces are implemented
+	void BuildDispatchTable();
+
+	const FMMovementMode_DispatchTable& GetDispatchTable() const { return DispatchTable; }
+
+	bool ImplementsOrientToMovementInterface() const { return DispatchTable.bImplementsOrientToMovementInterface; }
+
+	// Called after all movement modes of the movement component are initialized and registered
+	virtual void OnMovementModesRegistered() {}
+
+	// Whether MCharacterMovementComponent may skip ticking this mode while the character is idle
+	virtual bool AllowsMovementSleep() const;
+
+	// Restarts cooldown of the mode, does nothing for modes without one
+	UFUNCTION(BlueprintCallable)
+	virtual void ActivateCooldown() {}
+
+	const FMMovementModeTransitionConfig& GetTransitionConfig() const { return TransitionConfig; }
+
+	// Index of the mode in the movement mode registry, also its bit in movement mode masks
+	int32 GetMovementModeSlot() const { return MovementModeSlot; }
+	void SetMovementModeSlot(const int32 InMovementModeSlot) { MovementModeSlot = InMovementModeSlot; }
+
+	// EMCustomMovementMode value this mode runs as. Modes without one (INDEX_NONE) are assigned a value past the enum range
+	virtual int32 GetReservedCustomMovementMode() const { return INDEX_NONE; }
+
+	// Custom movement mode byte assigned by the movement mode registry of MCharacterMovementComponent, INDEX_NONE if unassigned
+	UFUNCTION(BlueprintCallable)
+	int32 GetCustomMovementModeByte() const { return CustomMovementModeByte; }
+
+	void SetCustomMovementModeByte(const int32 InCustomMovementModeByte) { CustomMovementModeByte = InCustomMovementModeByte; }
+
+	// Event calls through the dispatch table. Used by MCharacterMovementComponent in hot paths instead of the event thunks
+	void DispatchTick(float DeltaTime);
+	bool DispatchCanStart(FMMovementMode_FailReason& OutFailReason);
+	void DispatchStart();
+	void DispatchPhys(float DeltaTime, int32 Iterations);
+	void DispatchEnd();
+	bool DispatchCanCrouch();
+	bool DispatchIsMovingOnGround();
+	bool DispatchIsMovingOnSurface();
+	bool DispatchIsUsingCustomMovementBase();
+	FRotator DispatchComputeOrientToMovementRotation(const FRotator& CurrentRotation, float DeltaTime, FRotator& DeltaRotation);
+
 	// Called every frame by MCharacterMovementComponent when this movement mode is active 
 	// void GetInputVector();
 
-	FString GetCanStartFailReasonCache() const { return CanStartFailReasonCache; }
-	void SetCanStartFailReasonCache(const FString& FailReason) { CanStartFailReasonCache = FailReason; }
+	/**
+	 * Requests CanStart evaluation on the next movement update
+	 * Ignored if Condition is not one of this mode's WakeConditions
+	 */
+	UFUNCTION(BlueprintCallable)
+	void WakeActivationCheck(EMMovementModeWakeCondition Condition);
+
+	// Returns true if CanStart should be evaluated for conditions fired by the movement component. Clears signaled conditions
+	bool ConsumeActivationWake(EMMovementModeWakeCondition FiredConditions);
+
+	const FMMovementMode_FailReason& GetCanStartFailReasonCache() const { return CanStartFailReasonCache; }
+	void SetCanStartFailReasonCache(const FMMovementMode_FailReason& FailReason) { CanStartFailReasonCache = FailReason; }
+
+	// Why this mode could not start on the last evaluation, formatted on demand
+	UFUNCTION(BlueprintCallable)
+	FString GetCanStartFailReasonString() const { return CanStartFailReasonCache.ToString(); }
 
 protected:
 	UFUNCTION(BlueprintCallable)
 	FVector GetOwnerLocation() const;
 
+	// Ticks the timer and signals TimerExpired when it completes during this tick
+	void TickTimerWithActivationWake(FMManualTimer& Timer, float DeltaTime);
+
+	// Makes traversal index include surfaces of the filter. Reports user error if the filter can't be served by the index
+	void RegisterTraversalIndexSurfaceFilter(const FMMovementSurfaceFilter& SurfaceFilter);
+
+	// Classifies the surface with category masks, or with component tags in worlds without surface subsystem
+	EMMovementSurfaceFilterResult ClassifySurface(const FMMovementSurfaceFilter& SurfaceFilter, const UPrimitiveComponent* PrimitiveComponent,
+	                                              FName* OutExcludedCategory = nullptr) const;
+
 #if ENABLE_VISUAL_LOG
 	// Override to add info to visual log
 	virtual void AddVisualLoggerInfo(struct FVisualLogEntry* Snapshot,
@@ -113,6 +247,15 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly)
 	FName MovementModeName;
 
+	// When CanStart is evaluated. Always keeps polling CanStart on every movement update
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Activation",
+		meta = (Bitmask, BitmaskEnum = "/Script/MMovement.EMMovementModeWakeCondition"))
+	int32 WakeConditions = static_cast<int32>(EMMovementModeWakeCondition::Always);
+
+	// Which active modes this mode can interrupt and which cooldowns it activates when it ends
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Activation")
+	FMMovementModeTransitionConfig TransitionConfig;
+
 	UPROPERTY(BlueprintReadOnly)
 	TObjectPtr<UMCharacterMovementComponent> MovementComponent;
 
@@ -123,7 +266,27 @@ protected:
 	UPROPERTY(BlueprintReadOnly)
 	TObjectPtr<USceneComponent> UpdatedComponent;
 
+	// Resolves surface categories for surface filters of the mode, nullptr in preview and inactive worlds
+	UPROPERTY(Transient)
+	TObjectPtr<UMMovementSurfaceSubsystem> SurfaceSubsystem;
+
+	// Index of traversable surfaces modes can query instead of physics, nullptr in worlds without gameplay
+	UPROPERTY(Transient)
+	TObjectPtr<UMTraversalIndexSubsystem> TraversalIndexSubsystem;
+
+	// Baked traversal fields of streamed in regions, modes can query them instead of physics
+	UPROPERTY(Transient)
+	TObjectPtr<UMTraversalFieldSubsystem> TraversalFieldSubsystem;
+
 	bool bMovementModeActive;
 
-	FString CanStartFailReasonCache;
+	FMMovementMode_FailReason CanStartFailReasonCache;
+
+	FMMovementMode_DispatchTable DispatchTable;
+
+	// Conditions signaled by this mode since CanStart was last evaluated
+	EMMovementModeWakeCondition PendingWakeConditions = EMMovementModeWakeCondition::None;
+
+	int32 MovementModeSlot = INDEX_NONE;
+	int32 CustomMovementModeByte = INDEX_NONE;
 };
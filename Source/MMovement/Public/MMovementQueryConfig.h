@@ -0,0 +1,61 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "WorldCollision.h"
+#include "Engine/CollisionProfile.h"
+#include "MMovementQueryConfig.generated.h"
+
+UENUM(BlueprintType)
+enum class EMMovementQueryType : uint8
+{
+	// Objects blocking or overlapping TraceChannel
+	Channel,
+
+	// Objects responding to CollisionProfile
+	Profile,
+
+	// Objects of any of ObjectTypes
+	ObjectTypes
+};
+
+/**
+ * What movement sensing queries (surface sweeps, ground probe) collide with
+ * Defaults to ECC_WorldStatic. To keep static clutter (props, decals, foliage) out of movement queries, add a dedicated
+ * trace channel (e.g., "MMovementTraversable", see Config/DefaultMMovement.ini), block it on traversable geometry only
+ * and select it here
+ */
+USTRUCT(BlueprintType)
+struct MMOVEMENT_API FMMovementQueryConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Query")
+	EMMovementQueryType QueryType = EMMovementQueryType::Channel;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Query",
+		meta = (EditCondition = "QueryType == EMMovementQueryType::Channel", EditConditionHides))
+	TEnumAsByte<ECollisionChannel> TraceChannel = ECC_WorldStatic;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Query",
+		meta = (EditCondition = "QueryType == EMMovementQueryType::Profile", EditConditionHides))
+	FCollisionProfileName CollisionProfile;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Query",
+		meta = (EditCondition = "QueryType == EMMovementQueryType::ObjectTypes", EditConditionHides))
+	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
+
+	bool SweepMulti(const UWorld* World, TArray<FHitResult>& OutHits, const FVector& Start, const FVector& End, const FQuat& Rotation,
+	                const FCollisionShape& CollisionShape, const FCollisionQueryParams& QueryParams) const;
+
+	bool LineTraceSingle(const UWorld* World, FHitResult& OutHit, const FVector& Start, const FVector& End,
+	                     const FCollisionQueryParams& QueryParams) const;
+
+	FTraceHandle AsyncSweepMulti(UWorld* World, const FVector& Start, const FVector& End, const FQuat& Rotation,
+	                             const FCollisionShape& CollisionShape, const FCollisionQueryParams& QueryParams) const;
+
+private:
+	FCollisionObjectQueryParams MakeObjectQueryParams() const { return FCollisionObjectQueryParams(ObjectTypes); }
+};
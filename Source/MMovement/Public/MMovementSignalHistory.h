@@ -0,0 +1,116 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Fixed-capacity, timestamped history of a single movement signal (e.g., horizontal speed)
+ * Peak over the time window is kept at the front of a monotonic deque, so queries are O(1) and pushes are O(1) amortized
+ * Storage is allocated once in Initialize, pushing samples afterward doesn't touch the heap
+ */
+struct FMMovementSignalHistory
+{
+	struct FSample
+	{
+		double Time = 0;
+		float Value = 0;
+
+		// Vector the value was derived from (e.g., horizontal velocity for horizontal speed)
+		FVector Vector = FVector::ZeroVector;
+	};
+
+	void Initialize(const int32 InCapacity, const float InWindowDuration)
+	{
+		Capacity = FMath::Max(InCapacity, 1);
+		WindowDuration = InWindowDuration;
+
+		Samples.SetNumUninitialized(Capacity);
+		PeakDeque.SetNumUninitialized(Capacity);
+
+		Clear();
+	}
+
+	void Clear()
+	{
+		SampleHead = 0;
+		SampleTail = 0;
+		DequeHead = 0;
+		DequeTail = 0;
+	}
+
+	bool IsEmpty() const { return SampleHead == SampleTail; }
+
+	void Push(const double Time, const float Value, const FVector& Vector)
+	{
+		if (Capacity == 0)
+			return;
+
+		// Drop samples that left the window
+		while (!IsEmpty() && GetSample(SampleHead).Time < Time - WindowDuration)
+		{
+			PopOldestSample();
+		}
+
+		// Buffer is full (more samples than expected for the window), overwrite the oldest one
+		if (SampleTail - SampleHead >= static_cast<uint64>(Capacity))
+		{
+			PopOldestSample();
+		}
+
+		// Samples lower than the new one can never be the peak again
+		while (DequeHead != DequeTail && GetSample(GetDequeEntry(DequeTail - 1)).Value <= Value)
+		{
+			--DequeTail;
+		}
+
+		const uint64 SampleIndex = SampleTail++;
+		FSample& Sample = Samples[SampleIndex % Capacity];
+		Sample.Time = Time;
+		Sample.Value = Value;
+		Sample.Vector = Vector;
+
+		PeakDeque[DequeTail % Capacity] = SampleIndex;
+		++DequeTail;
+	}
+
+	// Sample with the highest value in the window, nullptr if history is empty
+	const FSample* GetPeak() const
+	{
+		if (DequeHead == DequeTail)
+			return nullptr;
+
+		return &GetSample(GetDequeEntry(DequeHead));
+	}
+
+	float GetWindowDuration() const { return WindowDuration; }
+
+private:
+	const FSample& GetSample(const uint64 SampleIndex) const { return Samples[SampleIndex % Capacity]; }
+	uint64 GetDequeEntry(const uint64 DequeIndex) const { return PeakDeque[DequeIndex % Capacity]; }
+
+	void PopOldestSample()
+	{
+		if (DequeHead != DequeTail && GetDequeEntry(DequeHead) == SampleHead)
+		{
+			++DequeHead;
+		}
+
+		++SampleHead;
+	}
+
+private:
+	TArray<FSample> Samples;
+
+	// Indices of samples in decreasing value order, front is the peak of the window
+	TArray<uint64> PeakDeque;
+
+	// Monotonic indices, wrapped by Capacity when accessing storage
+	uint64 SampleHead = 0;
+	uint64 SampleTail = 0;
+	uint64 DequeHead = 0;
+	uint64 DequeTail = 0;
+
+	int32 Capacity = 0;
+	float WindowDuration = 0;
+};
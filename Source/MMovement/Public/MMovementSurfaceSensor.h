@@ -0,0 +1,63 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MMovementQueryConfig.h"
+#include "MMovementTypes.h"
+#include "WorldCollision.h"
+
+// Component-local queries refining sweep hits during surface validation
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Surface Assist Queries"), STAT_MMovement_SurfaceAssistQueries, STATGROUP_MMovement, MMOVEMENT_API);
+
+// Sweep hits that didn't need an assist query (precise impact or duplicate component)
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Surface Assist Queries Skipped"), STAT_MMovement_SurfaceAssistQueriesSkipped, STATGROUP_MMovement, MMOVEMENT_API);
+
+/**
+ * Surface sweep that can be issued either synchronously or through the async trace API
+ * Async sweeps are double-buffered: sweep requested this frame is consumed next frame, while the next one is already in flight
+ * Trace start and end of consumed hits are translated by the difference between the actual and predicted sweep start
+ * Impacts are kept as they are, prediction error is bounded by the max prediction error passed to ConsumeAsyncSweep
+ */
+struct MMOVEMENT_API FMMovementSurfaceSensor
+{
+	// Blocking sweep, results are available immediately
+	static void SweepSync(const UWorld* World, const FVector& Start, const FVector& End, const FMMovementQueryConfig& QueryConfig,
+	                      const FCollisionShape& CollisionShape, const FCollisionQueryParams& QueryParams, TArray<FHitResult>& OutHits);
+
+	// Requests async sweep from PredictedStart, to be consumed with ConsumeAsyncSweep next frame
+	void RequestAsyncSweep(UWorld* World, const FVector& PredictedStart, const FVector& PredictedEnd, const FMMovementQueryConfig& QueryConfig,
+	                       const FCollisionShape& CollisionShape, const FCollisionQueryParams& QueryParams);
+
+	/**
+	 * Consumes sweep requested in the previous frame
+	 * Returns false when there is no usable result: nothing was requested, result is not ready yet,
+	 * or actual start is further than MaxPredictionError from the predicted one. Caller should fall back to SweepSync then
+	 */
+	bool ConsumeAsyncSweep(UWorld* World, const FVector& ActualStart, float MaxPredictionError, TArray<FHitResult>& OutHits);
+
+	// Drops in-flight requests, e.g., when switching back to sync sensing
+	void Reset();
+
+	/**
+	 * Sweep impact normal matches the shape normal (flat face hit, not an edge or a vertex) and sweep didn't start penetrating
+	 * Such hits don't need an assist query to get a precise normal and snap location
+	 */
+	static bool IsImpactPrecise(const FHitResult& Hit)
+	{
+		return !Hit.bStartPenetrating && Hit.Normal.Equals(Hit.ImpactNormal, 0.001f);
+	}
+
+	bool HasPendingRequest() const { return PendingRequests[RequestIndex ^ 1].Handle.IsValid(); }
+
+private:
+	struct FRequest
+	{
+		FTraceHandle Handle;
+		FVector PredictedStart = FVector::ZeroVector;
+	};
+
+	// Request issued this frame is written to RequestIndex, the one from previous frame is read from RequestIndex ^ 1
+	FRequest PendingRequests[2];
+	int32 RequestIndex = 0;
+};
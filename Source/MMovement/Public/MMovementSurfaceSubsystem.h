@@ -0,0 +1,101 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "MMovementSurfaceSubsystem.generated.h"
+
+class UMMovementSurfaceSubsystem;
+
+enum class EMMovementSurfaceFilterResult : uint8
+{
+	Passed,
+
+	// Surface doesn't have the required category
+	MissingRequiredCategory,
+
+	// Surface has one of the excluded categories
+	ExcludedCategory
+};
+
+/**
+ * Required/excluded surface categories compiled to bit masks of UMMovementSurfaceSubsystem
+ * Authored as names in mode configs, compiled once at initialization so classifying a surface is a single mask test
+ * Names are kept for worlds without the subsystem, where surfaces are classified by component tags instead
+ */
+struct MMOVEMENT_API FMMovementSurfaceFilter
+{
+	// RequiredCategory can be None to accept surfaces without any category. Masks stay empty without SurfaceSubsystem
+	void Compile(UMMovementSurfaceSubsystem* SurfaceSubsystem, FName RequiredCategory, TConstArrayView<FName> ExcludedCategories);
+
+	EMMovementSurfaceFilterResult Classify(const uint64 SurfaceCategoryMask) const
+	{
+		if ((SurfaceCategoryMask & RequiredMask) != RequiredMask)
+			return EMMovementSurfaceFilterResult::MissingRequiredCategory;
+
+		if ((SurfaceCategoryMask & ExcludedMask) != 0)
+			return EMMovementSurfaceFilterResult::ExcludedCategory;
+
+		return EMMovementSurfaceFilterResult::Passed;
+	}
+
+	bool Passes(const uint64 SurfaceCategoryMask) const { return Classify(SurfaceCategoryMask) == EMMovementSurfaceFilterResult::Passed; }
+
+	// Classification by component tags, for worlds without UMMovementSurfaceSubsystem
+	EMMovementSurfaceFilterResult ClassifyByTags(const UPrimitiveComponent* PrimitiveComponent, FName* OutExcludedCategory = nullptr) const;
+
+	uint64 RequiredMask = 0;
+	uint64 ExcludedMask = 0;
+
+	FName RequiredCategory;
+	TArray<FName> ExcludedCategories;
+};
+
+/**
+ * Registry of movement surface categories and cache of category masks of primitive components
+ * Categories come from UMMovementSurfaceUserData on the component or its static mesh. Component tags that match
+ * a registered category are included as well, so surfaces tagged before UMMovementSurfaceUserData existed keep working
+ */
+UCLASS()
+class MMOVEMENT_API UMMovementSurfaceSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr int32 MaxCategoryCount = 64;
+
+	// Bit assigned to the category, registered on first use. INDEX_NONE if all bits are taken or category is None
+	int32 RegisterCategory(FName Category);
+
+	FName GetCategoryName(int32 CategoryBit) const;
+
+	// Categories of the component as bit mask, resolved on first query and cached
+	uint64 GetSurfaceCategoryMask(const UPrimitiveComponent* PrimitiveComponent);
+
+	// Call when categories of the component changed at runtime (e.g., tags were added)
+	void InvalidateSurfaceCategoryMask(const UPrimitiveComponent* PrimitiveComponent);
+
+	// Name of the lowest category bit set in the mask, for diagnostics
+	FName GetFirstCategoryName(uint64 CategoryMask) const;
+
+	// Categories from UMMovementSurfaceUserData of the component and its static mesh, without component tags
+	static void GatherUserDataCategories(const UPrimitiveComponent* PrimitiveComponent, TArray<FName>& OutCategories);
+
+protected:
+	uint64 ResolveSurfaceCategoryMask(const UPrimitiveComponent* PrimitiveComponent);
+
+	void RemoveStaleSurfaceCategoryMasks();
+
+protected:
+	// Category name for each bit
+	TArray<FName> Categories;
+
+	TMap<FName, int32> CategoryBitMap;
+
+	TMap<TObjectKey<UPrimitiveComponent>, uint64> SurfaceCategoryMasks;
+
+	// Stale entries of destroyed components are removed when cache grows past this
+	int32 SurfaceCategoryMasksCompactThreshold = 1024;
+};
@@ -0,0 +1,22 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "MMovementSurfaceUserData.generated.h"
+
+/**
+ * Describes how movement modes treat a surface (e.g., wall runnable, slidable, excluded from slopes)
+ * Add to a static mesh asset or directly to a primitive component. Categories are matched against surface filters
+ * of movement mode configs the same way component tags are
+ */
+UCLASS(BlueprintType, meta = (DisplayName = "MMovement Surface"))
+class MMOVEMENT_API UMMovementSurfaceUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Surface")
+	TArray<FName> SurfaceCategories;
+};
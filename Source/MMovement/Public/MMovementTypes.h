@@ -3,12 +3,41 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
 #include "MMovementTypes.generated.h"
 
 MMOVEMENT_API DECLARE_LOG_CATEGORY_EXTERN(LogMMovement, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("MMovement"), STATGROUP_MMovement, STATCAT_Advanced);
+
+// How many movement mode event calls were dispatched natively instead of going through ProcessEvent
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Script Calls Avoided"), STAT_MMovement_ScriptCallsAvoided, STATGROUP_MMovement, MMOVEMENT_API);
+
 MMOVEMENT_API extern TAutoConsoleVariable<bool> CVarShowMovementDebugs;
 
+// Debug draws, on-screen messages and visual logging of movement. Compiled out of Shipping and dedicated server builds unless overridden
+#ifndef MMOVEMENT_ENABLE_DEBUG
+#define MMOVEMENT_ENABLE_DEBUG (!UE_BUILD_SHIPPING && !UE_SERVER)
+#endif
+
+#if MMOVEMENT_ENABLE_DEBUG
+#define MMOVEMENT_VLOG(...) UE_VLOG(__VA_ARGS__)
+#define MMOVEMENT_VLOG_ARROW(...) UE_VLOG_ARROW(__VA_ARGS__)
+#else
+#define MMOVEMENT_VLOG(...)
+#define MMOVEMENT_VLOG_ARROW(...)
+#endif
+
+// Debug draws and on-screen messages are shown, constant false when debug is compiled out so the debug branches are stripped
+FORCEINLINE bool ShouldShowMovementDebugs()
+{
+#if MMOVEMENT_ENABLE_DEBUG
+	return CVarShowMovementDebugs.GetValueOnGameThread();
+#else
+	return false;
+#endif
+}
+
 inline FName WallRunnableTagName = TEXT("WR");
 
 UENUM(BlueprintType)
@@ -20,6 +49,169 @@ enum EMCustomMovementMode : uint8
 	CMOVE_VerticalWallRun = 3 UMETA(DisplayName = "Vertical Wall Run"),
 };
 
+// Conditions on which MCharacterMovementComponent evaluates CanStart of a movement mode
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EMMovementModeWakeCondition : uint8
+{
+	None = 0 UMETA(Hidden),
+
+	// Evaluated on every movement update
+	Always = 1 << 0,
+
+	// Input that may start the mode was received (signaled by the mode)
+	InputTriggered = 1 << 1,
+
+	// Evaluated on every movement update while character is falling
+	Falling = 1 << 2,
+
+	// Character went from falling to not falling or the other way around
+	FallingTransition = 1 << 3,
+
+	// Surface sensing result of the mode changed (signaled by the mode)
+	SurfaceSensorChanged = 1 << 4,
+
+	// Timer of the mode (e.g., cooldown) expired (signaled by the mode)
+	TimerExpired = 1 << 5,
+};
+
+ENUM_CLASS_FLAGS(EMMovementModeWakeCondition);
+
+// Why a movement mode can't start or continue
+UENUM(BlueprintType)
+enum class EMMovementMode_FailReasonCode : uint8
+{
+	None,
+
+	// Reason described only by Context (e.g., set from Blueprint)
+	Custom,
+	NotFalling,
+
+	// Blocked by the active movement mode (Context is its name)
+	MovementModeActive,
+	Cooldown,
+	NotTriggeredByInput,
+	InputNotHeld,
+	AwaitsInputUp,
+	ChargesDepleted,
+	SurfaceInvalid,
+	TooCloseToGround,
+	HorizontalSpeedTooLow,
+	VerticalSpeedTooLow,
+	SurfaceToForwardAngleTooLow,
+	SurfaceToForwardAngleTooHigh,
+	SurfaceToVelocityAngleTooHigh,
+	SurfaceNormalAngleChangeTooHigh,
+	CannotRunBackwards,
+	SlideDirectionUndetermined,
+	CannotStartFromFalling
+};
+
+/**
+ * Compact record of a failed CanStart/CanContinue check
+ * Stored inline without allocations, formatted to text only when requested (visual logger, debug UI)
+ */
+USTRUCT(BlueprintType)
+struct MMOVEMENT_API FMMovementMode_FailReason
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	EMMovementMode_FailReasonCode Code = EMMovementMode_FailReasonCode::None;
+
+	// Value that failed the check
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Value = 0;
+
+	// Limit the value was checked against
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Limit = 0;
+
+	// Additional context, e.g., name of the blocking movement mode or custom reason
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FName Context = NAME_None;
+
+	FMMovementMode_FailReason() = default;
+
+	FMMovementMode_FailReason(const EMMovementMode_FailReasonCode Code)
+		: Code(Code)
+	{
+	}
+
+	FMMovementMode_FailReason(const EMMovementMode_FailReasonCode Code, const float Value, const float Limit)
+		: Code(Code),
+		  Value(Value),
+		  Limit(Limit)
+	{
+	}
+
+	FMMovementMode_FailReason(const EMMovementMode_FailReasonCode Code, const FName Context)
+		: Code(Code),
+		  Context(Context)
+	{
+	}
+
+	bool IsSet() const { return Code != EMMovementMode_FailReasonCode::None; }
+
+	FString ToString() const;
+};
+
+// Movement signals tracked over time by MCharacterMovementComponent
+UENUM(BlueprintType)
+enum class EMMovementSignal : uint8
+{
+	// Size of horizontal velocity
+	HorizontalSpeed,
+
+	// Z of velocity
+	VerticalSpeed,
+
+	// Size of acceleration
+	Acceleration,
+
+	MAX UMETA(Hidden)
+};
+
+// Identifies a controlled launch added to UMControlledLaunchManager. Becomes stale when the launch is removed
+USTRUCT(BlueprintType)
+struct MMOVEMENT_API FMControlledLaunchHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 SlotIndex = INDEX_NONE;
+
+	// Slot generation at the time launch was added, slot generation changes when the launch is removed
+	UPROPERTY()
+	int32 Generation = 0;
+
+	FMControlledLaunchHandle() = default;
+
+	FMControlledLaunchHandle(const int32 SlotIndex, const int32 Generation)
+		: SlotIndex(SlotIndex),
+		  Generation(Generation)
+	{
+	}
+
+	bool IsSet() const { return SlotIndex != INDEX_NONE; }
+
+	bool operator==(const FMControlledLaunchHandle& Other) const
+	{
+		return SlotIndex == Other.SlotIndex && Generation == Other.Generation;
+	}
+};
+
+// How movement modes query surfaces they move along
+UENUM(BlueprintType)
+enum class EMMovementSurfaceSensingMode : uint8
+{
+	// Blocking sweep every frame
+	Sync,
+
+	// Sweep requested at the end of the frame from predicted location and consumed in the next one
+	// Falls back to Sync when result isn't ready or prediction was off by more than allowed
+	Async
+};
+
 UENUM(BlueprintType)
 enum class EMSlopeDirection : uint8
 {
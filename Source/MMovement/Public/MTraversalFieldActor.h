@@ -0,0 +1,41 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "MTraversalFieldActor.generated.h"
+
+class UMTraversalFieldAsset;
+
+/**
+ * Places a baked traversal field in the level. Spawned by UMTraversalFieldBakeCommandlet, one per field region
+ * Streaming bounds match the baked region, so World Partition loads the field together with the geometry it describes
+ */
+UCLASS(NotBlueprintable)
+class MMOVEMENT_API AMTraversalFieldActor : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AMTraversalFieldActor();
+
+	// ~ AActor
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+#if WITH_EDITOR
+	virtual FBox GetStreamingBounds() const override;
+	virtual bool CanChangeIsSpatiallyLoadedFlag() const override { return false; }
+#endif
+	// ~ AActor
+
+	UMTraversalFieldAsset* GetFieldAsset() const { return FieldAsset; }
+
+#if WITH_EDITOR
+	void SetFieldAsset(UMTraversalFieldAsset* InFieldAsset);
+#endif
+
+protected:
+	UPROPERTY(VisibleAnywhere, Category = "Traversal Field")
+	TObjectPtr<UMTraversalFieldAsset> FieldAsset;
+};
@@ -0,0 +1,119 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "MTraversalFieldAsset.generated.h"
+
+// Nearest traversable surface for one cell of the field
+struct FMTraversalFieldCell
+{
+	FIntVector Cell = FIntVector::ZeroValue;
+
+	// Point on the surface nearest to the cell center, in world space
+	FVector3f SurfacePoint = FVector3f::ZeroVector;
+
+	FVector3f SurfaceNormal = FVector3f::ZeroVector;
+
+	// Distance from the cell center to SurfacePoint
+	float SnapDistance = 0;
+
+	// Bits index UMTraversalFieldAsset::Categories
+	uint64 CategoryMask = 0;
+
+	bool operator<(const FMTraversalFieldCell& Other) const { return IsCellLess(Cell, Other.Cell); }
+
+	static bool IsCellLess(const FIntVector& A, const FIntVector& B)
+	{
+		if (A.Z != B.Z)
+			return A.Z < B.Z;
+
+		if (A.Y != B.Y)
+			return A.Y < B.Y;
+
+		return A.X < B.X;
+	}
+
+	friend FArchive& operator<<(FArchive& Ar, FMTraversalFieldCell& FieldCell)
+	{
+		Ar << FieldCell.Cell << FieldCell.SurfacePoint << FieldCell.SurfaceNormal << FieldCell.SnapDistance << FieldCell.CategoryMask;
+		return Ar;
+	}
+};
+
+template <>
+struct TCanBulkSerialize<FMTraversalFieldCell>
+{
+	enum { Value = true };
+};
+
+struct FMTraversalFieldBakeSettings
+{
+	// Only surfaces with any of these categories are baked, category bits of cells follow this order
+	TArray<FName> Categories;
+
+	float CellSize = 50;
+
+	// Cells further than this from any baked surface are not stored
+	float MaxSnapDistance = 150;
+
+	// Size of the region covered by one asset, matches World Partition cell size so each asset streams with its cell
+	float RegionSize = 25600;
+};
+
+/**
+ * Traversal field of a level region baked by UMTraversalFieldBakeCommandlet
+ * Sparse grid storing the nearest traversable surface of every cell near such surfaces
+ * Cells are sorted, so lookups are a binary search over a flat array, which is bulk serialized as a single block
+ * Streamed by AMTraversalFieldActor and queried through UMTraversalFieldSubsystem
+ */
+UCLASS(BlueprintType)
+class MMOVEMENT_API UMTraversalFieldAsset : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// ~ UObject
+	virtual void Serialize(FArchive& Ar) override;
+	// ~ UObject
+
+	const FMTraversalFieldCell* FindCell(const FIntVector& Cell) const;
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	const FBox& GetBounds() const { return Bounds; }
+	const TArray<FName>& GetCategories() const { return Categories; }
+	const TArray<FMTraversalFieldCell>& GetCells() const { return Cells; }
+
+	// Hash of the content, equal for equal bakes. Used to validate bakes in automation
+	uint32 ComputeContentHash() const;
+
+#if WITH_EDITOR
+	/**
+	 * Bakes fields of all loaded static components of the world, one entry per non-empty region
+	 * Deterministic: components are processed in path name order and cells are sorted
+	 */
+	static void BakeWorld(const UWorld* World, const FMTraversalFieldBakeSettings& Settings,
+	                      TMap<FIntVector, TArray<FMTraversalFieldCell>>& OutRegionCells);
+
+	void SetBakedData(const FBox& InBounds, float InCellSize, const TArray<FName>& InCategories, TArray<FMTraversalFieldCell>&& InCells);
+
+	// One line per cell, for diffing bakes
+	FString ExportText() const;
+#endif
+
+protected:
+	// Region covered by this asset
+	UPROPERTY(VisibleAnywhere, Category = "Traversal Field")
+	FBox Bounds = FBox(ForceInit);
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal Field")
+	float CellSize = 50;
+
+	UPROPERTY(VisibleAnywhere, Category = "Traversal Field")
+	TArray<FName> Categories;
+
+	// Sorted by cell, serialized in Serialize
+	TArray<FMTraversalFieldCell> Cells;
+};
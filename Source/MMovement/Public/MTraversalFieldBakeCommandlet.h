@@ -0,0 +1,27 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MTraversalFieldBakeCommandlet.generated.h"
+
+/**
+ * Bakes traversal fields (UMTraversalFieldAsset) of a map and places AMTraversalFieldActor for each field region
+ * Run as part of the cook pipeline, e.g.:
+ * UnrealEditor-Cmd Project.uproject -run=MTraversalFieldBake -Map=/Game/Maps/Level -Categories=WallRunnable,Slidable [-CellSize=50] [-Reach=150] [-RegionSize=25600] [-Dump]
+ * Bakes are deterministic, content hash of each field is logged and -Dump writes text export of every field to Saved/TraversalField for diffing
+ * Only actors loaded with the map are baked, World Partition maps need traversable geometry to be always loaded or loaded by a data layer when baking
+ */
+UCLASS()
+class MMOVEMENT_API UMTraversalFieldBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMTraversalFieldBakeCommandlet();
+
+	// ~ UCommandlet
+	virtual int32 Main(const FString& Params) override;
+	// ~ UCommandlet
+};
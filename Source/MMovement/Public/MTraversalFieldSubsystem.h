@@ -0,0 +1,73 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MTraversalFieldSubsystem.generated.h"
+
+struct FMMovementSurfaceFilter;
+class UMMovementSurfaceSubsystem;
+class UMTraversalFieldAsset;
+
+struct FMTraversalFieldSample
+{
+	FVector SurfacePoint = FVector::ZeroVector;
+	FVector SurfaceNormal = FVector::ZeroVector;
+
+	// Categories in bits of UMMovementSurfaceSubsystem
+	uint64 CategoryMask = 0;
+
+	float Distance = 0;
+};
+
+/**
+ * Lookups into baked traversal fields (UMTraversalFieldAsset) of currently streamed in regions
+ * Category bits of assets are remapped to bits of UMMovementSurfaceSubsystem when the field is registered,
+ * so queries take the same compiled surface filters as physics based sensing
+ * Only wall run uses fields for now: vertical wall run needs every wall hit for mantle checks and slide needs the surface below
+ * the character, while a cell stores only its nearest surface
+ */
+UCLASS()
+class MMOVEMENT_API UMTraversalFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// ~ UWorldSubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// ~ UWorldSubsystem
+
+	void RegisterField(UMTraversalFieldAsset* FieldAsset);
+	void UnregisterField(const UMTraversalFieldAsset* FieldAsset);
+
+	/**
+	 * Nearest baked surface passing the filter within MaxDistance of the location (within the precision of field cell size)
+	 * Returns false when no field covers the location or the filter uses categories that weren't baked, caller should use physics query then
+	 */
+	bool FindSurface(const FVector& Location, float MaxDistance, const FMMovementSurfaceFilter& SurfaceFilter, bool& bOutFound,
+	                 FMTraversalFieldSample& OutSample) const;
+
+	bool HasFields() const { return !Fields.IsEmpty(); }
+
+protected:
+	struct FRegisteredField
+	{
+		TObjectPtr<UMTraversalFieldAsset> FieldAsset;
+
+		// Runtime category bit for each bit of the asset
+		TArray<int32> CategoryBits;
+
+		// All runtime categories baked into the asset
+		uint64 BakedCategoryMask = 0;
+	};
+
+	uint64 RemapCategoryMask(const FRegisteredField& Field, uint64 AssetCategoryMask) const;
+
+protected:
+	UPROPERTY(Transient)
+	TObjectPtr<UMMovementSurfaceSubsystem> SurfaceSubsystem;
+
+	TArray<FRegisteredField> Fields;
+};
@@ -0,0 +1,187 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MMovementSurfaceSubsystem.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "MTraversalIndexSubsystem.generated.h"
+
+class UMMovementSurfaceSubsystem;
+
+// Triangle of a traversable surface in world space
+struct FMTraversalIndexTriangle
+{
+	FVector3f Vertices[3];
+	FVector3f Normal;
+	uint64 CategoryMask = 0;
+	TObjectKey<UPrimitiveComponent> Component;
+
+	// Prevents testing the same triangle twice in one query when it spans several cells
+	mutable uint32 QueryStamp = 0;
+};
+
+// Convex edge between a walkable top face and a wall face of a traversable surface, in world space
+struct FMTraversalIndexLedge
+{
+	FVector3f Start;
+	FVector3f End;
+
+	// Horizontal normal of the wall face, points away from the wall
+	FVector3f WallNormal;
+
+	uint64 CategoryMask = 0;
+	TObjectKey<UPrimitiveComponent> Component;
+
+	mutable uint32 QueryStamp = 0;
+};
+
+struct FMTraversalIndexLedgeHit
+{
+	// Closest point on the ledge edge
+	FVector Location = FVector::ZeroVector;
+
+	FVector WallNormal = FVector::ZeroVector;
+
+	// Height of the ledge above the query location
+	float Height = 0;
+
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+};
+
+/**
+ * Uniform grid of triangles of static traversable surfaces (components with categories required by registered surface filters)
+ * Lets movement modes find wall runnable and slidable surfaces without physics queries
+ * Ledges (convex edges between walkable top faces and walls) are extracted from the same triangles and kept in a separate grid
+ * Triangles are extracted from box and convex simple collision. Regions with components the index can't represent
+ * (other shapes, complex collision only, non-static mobility) are reported as unreliable, so callers fall back to physics queries
+ * Maintained incrementally when physics state of components is created or destroyed (register/unregister, level streaming)
+ * Categories of newly registered filters are indexed over several frames, the filters are served once all their components are in
+ */
+UCLASS()
+class MMOVEMENT_API UMTraversalIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static constexpr float CellSize = 500;
+
+	// ~ UWorldSubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// ~ UWorldSubsystem
+
+	/**
+	 * Components with the required or excluded categories of the filter will be indexed
+	 * Excluded surfaces are indexed so they occlude the required ones behind them, the same way they block physics queries
+	 * Filter without required category would include every surface in the world, it can't be served by the index and false is returned
+	 * Already indexed components are kept, only components of new categories are added, a few per frame
+	 */
+	bool RegisterSurfaceFilter(const FMMovementSurfaceFilter& SurfaceFilter);
+
+	bool CanServeSurfaceFilter(const FMMovementSurfaceFilter& SurfaceFilter) const;
+
+	// Adds component to the index (or updates it) if it has indexed categories
+	void RegisterSurfaceComponent(UPrimitiveComponent* PrimitiveComponent);
+	void UnregisterSurfaceComponent(const UPrimitiveComponent* PrimitiveComponent);
+
+	/**
+	 * Surfaces passing the filter touched by a vertical capsule swept from Start to End, as blocking hits
+	 * Sweep is sampled in steps of at most Radius, the earliest touch per component is returned like a physics sweep would
+	 * Indexed surfaces failing the filter block the sweep, surfaces touched only at later steps are not returned
+	 * Returns false when the index can't answer for this region or the sweep is longer than 16 radii,
+	 * caller should use physics query then
+	 */
+	bool QueryCapsule(const FVector& Start, const FVector& End, float Radius, float HalfHeight, const FMMovementSurfaceFilter& SurfaceFilter,
+	                  TArray<FHitResult>& OutHits);
+
+	/**
+	 * First indexed surface along the segment, bOutHit is set only if it passes the filter
+	 * Only indexed surfaces are considered, other geometry doesn't block the trace
+	 * Returns false when the index can't answer for this region, caller should use physics query then
+	 */
+	bool LineTrace(const FVector& Start, const FVector& End, const FMMovementSurfaceFilter& SurfaceFilter, bool& bOutHit,
+	               FHitResult& OutHit);
+
+	/**
+	 * Lowest ledge passing the filter above the location, at most MaxHeight higher and within Radius horizontally
+	 * Only ledges with wall facing against Facing (within 60 degrees) are considered
+	 * Returns false when the index can't answer for this region, caller should use physics query then
+	 */
+	bool FindLedgeAbove(const FVector& Location, const FVector& Facing, float Radius, float MaxHeight,
+	                    const FMMovementSurfaceFilter& SurfaceFilter, bool& bOutFound, FMTraversalIndexLedgeHit& OutLedge);
+
+	// Appends world space triangles of simple collision, false if collision has shapes the index can't represent
+	static bool GatherCollisionTriangles(const UPrimitiveComponent* PrimitiveComponent, TArray<FVector>& OutTriangleVertices);
+
+protected:
+	struct FComponentEntry
+	{
+		TArray<int32> TriangleIndices;
+		TArray<int32> LedgeIndices;
+		// Set since every triangle and ledge adds all cells it overlaps
+		TSet<FIntVector> Cells;
+		bool bUnreliable = false;
+	};
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void OnComponentPhysicsStateCreated(UActorComponent* Component);
+	void OnComponentPhysicsStateDestroyed(UActorComponent* Component);
+
+	// Indexes a slice of components of pending categories, once per frame
+	void EnsureIndexBuilt();
+
+	bool IsComponentIndexed(const UPrimitiveComponent* PrimitiveComponent) const;
+
+	void ExtractLedges(FComponentEntry& Entry, const UPrimitiveComponent* PrimitiveComponent, uint64 CategoryMask);
+
+	bool ShouldIndexComponent(const UPrimitiveComponent* PrimitiveComponent, uint64& OutCategoryMask) const;
+
+	bool IsRegionReliable(const FBox& Bounds, FIntVector CellMin, FIntVector CellMax) const;
+
+	static FIntVector GetCell(const FVector& Location);
+
+	FHitResult MakeHit(const FMTraversalIndexTriangle& Triangle, const FVector& TraceStart, const FVector& TraceEnd,
+	                   const FVector& ImpactPoint) const;
+
+protected:
+	UPROPERTY(Transient)
+	TObjectPtr<UMMovementSurfaceSubsystem> SurfaceSubsystem;
+
+	// Union of required and excluded masks of registered filters, components with any of these categories are indexed
+	uint64 IndexedCategoryMask = 0;
+
+	// Categories of filters registered since the last completed pass, indexed but not served yet
+	uint64 PendingCategoryMask = 0;
+
+	// Components of pending categories left to index, gathered once per pass
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> PendingComponents;
+	bool bPendingComponentsGathered = false;
+	uint64 PendingIndexFrame = MAX_uint64;
+
+	bool bWorldBegunPlay = false;
+
+	TSparseArray<FMTraversalIndexTriangle> Triangles;
+
+	TMap<FIntVector, TArray<int32>> CellTriangles;
+
+	TSparseArray<FMTraversalIndexLedge> Ledges;
+
+	TMap<FIntVector, TArray<int32>> CellLedges;
+
+	// Cells overlapping components that passed the filters but couldn't be indexed
+	TMap<FIntVector, int32> UnreliableCellRefCounts;
+
+	TMap<TObjectKey<UPrimitiveComponent>, FComponentEntry> ComponentEntries;
+
+	// Traversable components that can move, their current bounds make a region unreliable
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> NonStaticComponents;
+
+	uint32 QueryStamp = 0;
+
+	FDelegateHandle CreatePhysicsStateHandle;
+	FDelegateHandle DestroyPhysicsStateHandle;
+};
@@ -0,0 +1,40 @@
+// Copyright (c) Miknios. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SplineComponent.h"
+#include "MWallRunRailComponent.generated.h"
+
+/**
+ * Rail placed along a wall run surface, added to the actor that owns the wall
+ * Wall run attaches to the rail on start and advances along it analytically, without sensing the wall every frame
+ * Rail defines the horizontal path, vertical movement still comes from wall run gravity
+ */
+UCLASS(ClassGroup = (MMovement), meta = (BlueprintSpawnableComponent))
+class MMOVEMENT_API UMWallRunRailComponent : public USplineComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMWallRunRailComponent();
+
+	// Location of the runner (rail point pushed out by OffsetFromWall), wall normal and horizontal rail direction at the distance
+	void GetRunnerFrameAtDistance(float Distance, FVector& OutLocation, FVector& OutWallNormal, FVector& OutDirection) const;
+
+	float FindDistanceClosestToLocation(const FVector& Location) const;
+
+	// Wraps distance for closed loop rails, false if distance is past the end of the rail otherwise
+	bool WrapDistance(float& InOutDistance) const;
+
+	float GetOffsetFromWall() const { return OffsetFromWall; }
+
+protected:
+	// Wall normal is the horizontal right vector of the spline, flip it when the wall is on the other side of the rail
+	UPROPERTY(EditAnywhere, Category = "Wall Run Rail")
+	bool bFlipWallNormal = false;
+
+	// Distance of the runner's capsule center from the rail, along the wall normal
+	UPROPERTY(EditAnywhere, Category = "Wall Run Rail")
+	float OffsetFromWall = 50;
+};
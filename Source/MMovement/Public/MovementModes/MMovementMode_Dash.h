@@ -3,8 +3,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MBakedCurve.h"
 #include "MManualTimer.h"
 #include "MMovementMode_Base.h"
+#include "MMovementQueryConfig.h"
 #include "MMovementMode_Dash.generated.h"
 
 USTRUCT(BlueprintType)
@@ -105,6 +107,10 @@ struct FMCharacterMovement_DashConfig
 	
 	UPROPERTY(EditAnywhere, Category = "Dash Config|Damage")
 	float DamageCapsuleScale = 1.5f;
+
+	// What damage sweep collides with
+	UPROPERTY(EditAnywhere, Category = "Dash Config|Damage")
+	FMMovementQueryConfig DamageQueryConfig;
 };
 
 USTRUCT(BlueprintType)
@@ -146,15 +152,21 @@ class MMOVEMENT_API UMMovementMode_Dash : public UMMovementMode_Base
 	GENERATED_BODY()
 
 public:
+	UMMovementMode_Dash();
+
 	// ~ UMMovementMode_Base
 	virtual void Initialize_Implementation() override;
 	virtual void Tick_Implementation(float DeltaTime) override;
-	virtual bool CanStart_Implementation(FString& OutFailReason) override;
+	virtual bool CanStart_Implementation(FMMovementMode_FailReason& OutFailReason) override;
 	virtual void Start_Implementation() override;
 	virtual void Phys_Implementation(float DeltaTime, int32 Iterations) override;
 	virtual void End_Implementation() override;
 	virtual bool IsMovingOnGround_Implementation() override;
 	virtual bool IsMovingOnSurface_Implementation() override;
+	virtual int32 GetReservedCustomMovementMode() const override { return CMOVE_Dash; }
+	virtual void OnMovementModesRegistered() override;
+	virtual void ActivateCooldown() override;
+	virtual bool AllowsMovementSleep() const override;
 	// ~ UMMovementMode_Base
 
 	UFUNCTION(BlueprintCallable)
@@ -195,4 +207,11 @@ protected:
 
 	UPROPERTY(Transient, EditAnywhere, Category = "Dash Runtime Data", meta = (ShowOnlyInnerProperties))
 	FMCharacterMovement_DashRuntimeData RuntimeData;
+
+	// DashConfig.DistanceCurve baked on Initialize
+	UPROPERTY(Transient, VisibleInstanceOnly, Category = "Dash Runtime Data")
+	FMBakedCurve DistanceCurveBaked;
+
+	// Movement modes restoring charges while active, resolved from DashConfig once movement modes are registered
+	uint64 ChargeRestoreMovementModeMask = 0;
 };
@@ -57,10 +57,12 @@ class MMOVEMENT_API UMMovementMode_ForwardMovementFromAnimationCurve : public UM
 	GENERATED_BODY()
 
 public:
+	UMMovementMode_ForwardMovementFromAnimationCurve();
+
 	// ~ UMMovementMode_Base
 	virtual void Initialize_Implementation() override;
 	virtual void Tick_Implementation(float DeltaTime) override;
-	virtual bool CanStart_Implementation(FString& OutFailReason) override;
+	virtual bool CanStart_Implementation(FMMovementMode_FailReason& OutFailReason) override;
 	virtual void Start_Implementation() override;
 	virtual void Phys_Implementation(float DeltaTime, int32 Iterations) override;
 	virtual void End_Implementation() override;
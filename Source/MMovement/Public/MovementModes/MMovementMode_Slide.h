@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "MManualTimer.h"
 #include "MMovementMode_Base.h"
+#include "MMovementSurfaceSubsystem.h"
 #include "MMovementMode_Slide.generated.h"
 
 class UMControlledLaunchAsset;
@@ -68,22 +69,27 @@ struct FMMovementMode_SlideConfig
 	UPROPERTY(EditAnywhere, Category = "Slide Config|Slope")
 	float SlopeNormalAngleMin = 20;
 
-	// Surfaces with these tags will be excluded from slope detection
+	// Surfaces with these categories (UMMovementSurfaceUserData or component tags) will be excluded from slope detection
 	UPROPERTY(EditAnywhere, Category = "Slide Config|Slope")
 	TArray<FName> SlopeSurfaceDetectionExclusionTags = TArray<FName>();
 
-	// Only surfaces with this tag will be included for slope detection. Leave empty to include all surfaces
+	// Only surfaces with this category (UMMovementSurfaceUserData or component tag) will be included for slope detection. Leave empty to include all surfaces
 	UPROPERTY(EditAnywhere, Category = "Slide Config|Slope")
 	FName SlopeSurfaceDetectionRequirementTag = FName();
 
 	UPROPERTY(EditAnywhere, Category = "Slide Config|Surface Detection")
 	float SlideSurfaceDetectionMaxTraceDistance = 300;
 
-	// Surfaces with these tags will be excluded from slidable surface detection 
+	// Find slidable ground in UMTraversalIndexSubsystem instead of tracing physics scene, where the index is reliable
+	// Requires SlideSurfaceDetectionRequirementTag, so the index contains only tagged surfaces. Untagged geometry doesn't block index traces
+	UPROPERTY(EditAnywhere, Category = "Slide Config|Surface Detection")
+	bool bUseTraversalIndex = false;
+
+	// Surfaces with these categories (UMMovementSurfaceUserData or component tags) will be excluded from slidable surface detection
 	UPROPERTY(EditAnywhere, Category = "Slide Config|Surface Detection")
 	TArray<FName> SlideSurfaceDetectionExclusionTags;
 
-	// Only surfaces with this tag will be included for slidable surface detection. Leave empty to include all surfaces
+	// Only surfaces with this category (UMMovementSurfaceUserData or component tag) will be included for slidable surface detection. Leave empty to include all surfaces
 	UPROPERTY(EditAnywhere, Category = "Slide Config|Surface Detection")
 	FName SlideSurfaceDetectionRequirementTag = FName();
 
@@ -271,16 +277,21 @@ class MMOVEMENT_API UMMovementMode_Slide : public UMMovementMode_Base
 	GENERATED_BODY()
 
 public:
+	UMMovementMode_Slide();
+
 	// ~ UMMovementMode_Base
 	virtual void Initialize_Implementation() override;
 	virtual void Tick_Implementation(float DeltaTime) override;
-	virtual bool CanStart_Implementation(FString& OutFailReason) override;
+	virtual bool CanStart_Implementation(FMMovementMode_FailReason& OutFailReason) override;
 	virtual void Start_Implementation() override;
 	virtual void Phys_Implementation(float DeltaTime, int32 Iterations) override;
 	virtual void End_Implementation() override;
 	virtual bool CanCrouch_Implementation() override;
 	virtual bool IsMovingOnGround_Implementation() override;
 	virtual bool IsMovingOnSurface_Implementation() override;
+	virtual int32 GetReservedCustomMovementMode() const override { return CMOVE_Slide; }
+	virtual void ActivateCooldown() override;
+	virtual bool AllowsMovementSleep() const override;
 	// ~ UMMovementMode_Base
 
 protected:
@@ -309,4 +320,10 @@ protected:
 	FMMovementMode_SlideRuntimeData RuntimeData;
 
 	FCollisionQueryParams TraceQueryParams;
+
+	// Compiled from SlideSurfaceDetectionRequirementTag and SlideSurfaceDetectionExclusionTags
+	FMMovementSurfaceFilter SlideSurfaceFilter;
+
+	// Compiled from SlopeSurfaceDetectionRequirementTag and SlopeSurfaceDetectionExclusionTags
+	FMMovementSurfaceFilter SlopeSurfaceFilter;
 };
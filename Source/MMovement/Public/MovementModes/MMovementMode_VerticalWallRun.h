@@ -4,7 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "MManualTimer.h"
+#include "MMovementDiagnostics.h"
 #include "MMovementMode_Base.h"
+#include "MMovementSurfaceSensor.h"
+#include "MMovementSurfaceSubsystem.h"
+#include "MMovementTypes.h"
+#include "MTraversalIndexSubsystem.h"
 #include "MUtilityTypes.h"
 #include "MMovementMode_VerticalWallRun.generated.h"
 
@@ -96,14 +101,36 @@ struct FMCharacterMovement_VerticalWallRunConfig
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection")
 	float WallDetectionCapsuleSizeMultiplier = 0.3f;
 
+	// What wall detection sweep collides with
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection")
+	FMMovementQueryConfig SurfaceQueryConfig;
+
+	// Find walls in UMTraversalIndexSubsystem instead of sweeping physics scene, where the index is reliable
+	// Requires WallRunnableSurfaceTag/SurfaceRequirementTag, so the index contains only tagged surfaces
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection")
+	bool bUseTraversalIndex = false;
+
+	// Max height above the character of the ledge returned by GetLedgeAbove while climbing (requires bUseTraversalIndex)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection",
+		meta = (EditCondition = "bUseTraversalIndex", EditConditionHides))
+	float LedgeDetectionHeight = 150;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection")
+	EMMovementSurfaceSensingMode SurfaceSensingMode = EMMovementSurfaceSensingMode::Sync;
+
+	// Async sweep result is discarded (and sync sweep performed instead) when character ended up further than this from the predicted location
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection",
+		meta = (EditCondition = "SurfaceSensingMode == EMMovementSurfaceSensingMode::Async", EditConditionHides))
+	float AsyncSensingMaxPredictionError = 10;
+
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection")
 	float MaxDistanceFromWallToStart = 0;
 
-	// Surface with any of these tags will be excluded from wall run
+	// Surface with any of these categories (UMMovementSurfaceUserData or component tags) will be excluded from wall run
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection")
 	TArray<FName> SurfaceExclusionTags = TArray<FName>();
 
-	// Only surfaces with this tag will be included for vertical wall run. Leave empty to include all surfaces
+	// Only surfaces with this category (UMMovementSurfaceUserData or component tag) will be included for vertical wall run. Leave empty to include all surfaces
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vertical Wall Run Config|Surface Detection")
 	FName SurfaceRequirementTag = FName();
 
@@ -119,8 +146,7 @@ struct FMCharacterMovement_VerticalWallRunSurfaceHitInfo
 	bool bValid = false;
 	FVector SnapLocation = FVector::ZeroVector;
 	FVector Normal = FVector::ZeroVector;
-	FString Name = TEXT("None");
-	FString InvalidReason = FString();
+	FMMovementSurfaceValidationRecord Validation;
 };
 
 struct FMCharacterMovement_VerticalWallRunSurfaceInfo
@@ -129,6 +155,9 @@ struct FMCharacterMovement_VerticalWallRunSurfaceInfo
 	FVector SnapLocation = FVector::ZeroVector;
 	FVector Normal = FVector::ZeroVector;
 
+	// Component of the first valid hit
+	UPrimitiveComponent* PrimitiveComponent = nullptr;
+
 	// Query hits that were included to calculate final surface data
 	TArray<FMCharacterMovement_VerticalWallRunSurfaceHitInfo> SurfaceHitInfoArray;
 };
@@ -166,14 +195,25 @@ public:
 	// UMMovementMode_Base
 	virtual void Initialize_Implementation() override;
 	virtual void Tick_Implementation(float DeltaTime) override;
-	virtual bool CanStart_Implementation(FString& OutFailReason) override;
+	virtual bool CanStart_Implementation(FMMovementMode_FailReason& OutFailReason) override;
 	virtual void Start_Implementation() override;
 	virtual void Phys_Implementation(float DeltaTime, int32 Iterations) override;
-	virtual void End_Implementation() override;
 	virtual bool IsMovingOnGround_Implementation() override;
 	virtual bool IsMovingOnSurface_Implementation() override;
+	virtual int32 GetReservedCustomMovementMode() const override { return CMOVE_VerticalWallRun; }
+	virtual void ActivateCooldown() override;
+	virtual bool AllowsMovementSleep() const override;
 	// ~ UMMovementMode_Base
 
+	/**
+	 * Lowest ledge of a wall the character is facing, at most MaxHeight above the character
+	 * Returns false when traversal index is disabled or can't answer for this region
+	 */
+	bool FindLedgeAbove(float MaxHeight, bool& bOutFound, FMTraversalIndexLedgeHit& OutLedge) const;
+
+	// Ledge within LedgeDetectionHeight while climbing, queried from the index on call. False when there is none
+	bool GetLedgeAbove(FMTraversalIndexLedgeHit& OutLedge) const;
+
 protected:
 	// UMMovementMode_Base
 #if ENABLE_VISUAL_LOG
@@ -183,7 +223,7 @@ protected:
 #endif
 	// ~ UMMovementMode_Base
 
-	void SweepAndCalculateSurfaceInfo();
+	void SweepAndCalculateSurfaceInfo(float DeltaTime);
 
 	FMCharacterMovement_VerticalWallRunSurfaceInfo CalculateSurfaceInfo(const TArray<FHitResult>& Hits);
 
@@ -197,6 +237,9 @@ protected:
 
 	FVector GetSnapLocation() const;
 
+	// Correction toward OffsetFromWall from the surface, for the given location
+	FVector CalculateWallSnapDelta(const FVector& Location, float DeltaTime) const;
+
 	FVector GetJumpOffVelocity() const;
 
 protected:
@@ -208,6 +251,11 @@ protected:
 
 	FCollisionQueryParams WallDetectionQueryParams;
 
+	FMMovementSurfaceSensor SurfaceSensor;
+
+	// Compiled from SurfaceRequirementTag and SurfaceExclusionTags
+	FMMovementSurfaceFilter SurfaceFilter;
+
 public:
 	UPROPERTY(BlueprintAssignable, Category = "Vertical Wall Run Config")
 	FMDynamicMulticastDelegateSignature OnSlideDownStartedDelegate;
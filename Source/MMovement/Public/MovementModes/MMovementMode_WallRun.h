@@ -5,9 +5,13 @@
 #include "CoreMinimal.h"
 #include "MManualTimer.h"
 #include "MMovementMode_Base.h"
+#include "MMovementSurfaceSensor.h"
+#include "MMovementSurfaceSubsystem.h"
+#include "MMovementTypes.h"
 #include "MMovementMode_WallRun.generated.h"
 
 class UMControlledLaunchAsset;
+class UMWallRunRailComponent;
 
 struct MMOVEMENT_API FMCharacterMovement_WallRunSurfaceHitInfo
 {
@@ -127,23 +131,71 @@ struct MMOVEMENT_API FMCharacterMovement_WallRunConfig
 	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
 	float WallDetectionCapsuleSizeMultiplier = 2;
 
-	// Surface with any of these tags will be excluded from wall run
+	// What wall detection sweep collides with
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
+	FMMovementQueryConfig SurfaceQueryConfig;
+
+	// Find walls in UMTraversalIndexSubsystem instead of sweeping physics scene, where the index is reliable
+	// Requires WallRunnableSurfaceTag/SurfaceRequirementTag, so the index contains only tagged surfaces
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
+	bool bUseTraversalIndex = false;
+
+	// Find walls in baked traversal fields (UMTraversalFieldBakeCommandlet) where the level has them, before any other sensing
+	// Requires WallRunnableSurfaceTag and exclusion tags to be baked into the field. Walls missing from the field are sensed as usual
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
+	bool bUseTraversalField = false;
+
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
+	EMMovementSurfaceSensingMode SurfaceSensingMode = EMMovementSurfaceSensingMode::Sync;
+
+	// Async sweep result is discarded (and sync sweep performed instead) when character ended up further than this from the predicted location
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection",
+		meta = (EditCondition = "SurfaceSensingMode == EMMovementSurfaceSensingMode::Async", EditConditionHides))
+	float AsyncSensingMaxPredictionError = 10;
+
+	// Surface with any of these categories (UMMovementSurfaceUserData or component tags) will be excluded from wall run
 	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
 	TArray<FName> SurfaceExclusionTags = TArray<FName>();
 
-	// Only surfaces with this tag will be included for wall run. Leave empty to include all surfaces
+	// Only surfaces with this category (UMMovementSurfaceUserData or component tag) will be included for wall run. Leave empty to include all surfaces
 	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
 	FName WallRunnableSurfaceTag = FName();
 
+	// Ground with this category doesn't count when checking MinDistanceFromGround
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
+	FName GroundCheckIgnoredSurfaceTag = WallRunnableTagName;
+
 	// Wall run will be stopped when angle between current and previous surface normal was higher than this
 	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
 	float MaxSurfaceNormalAngleChangeToContinue = 60;
 
+	// While wall running, re-validate only the component character is running on instead of sweeping the world
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection")
+	bool bRevalidatePreviousSurfaceWhileActive = true;
+
+	// Full world sweep is forced after this many frames of re-validating the previous surface, to pick up nearby surfaces
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection",
+		meta = (EditCondition = "bRevalidatePreviousSurfaceWhileActive", EditConditionHides, ClampMin = 1))
+	int32 FullSweepFrameInterval = 10;
+
+	// Re-validation fails (and full world sweep is performed) when surface normal changed more than this since the previous frame
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Surface Detection",
+		meta = (EditCondition = "bRevalidatePreviousSurfaceWhileActive", EditConditionHides))
+	float RevalidationMaxSurfaceNormalAngleChange = 10;
+
 	UPROPERTY(EditAnywhere)
 	float OffsetFromWall = 45;
 
 	UPROPERTY(EditAnywhere)
 	float WallOffsetSnapSpeed = 4;
+
+	// Attach to UMWallRunRailComponent of the wall owner on start and move along it instead of sensing and snapping to the wall
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Rail")
+	bool bUseWallRunRails = true;
+
+	// Rail is ignored when character is further than this from it on start
+	UPROPERTY(EditAnywhere, Category = "Wall Run Config|Rail", meta = (EditCondition = "bUseWallRunRails", EditConditionHides))
+	float RailAttachMaxDistance = 100;
 };
 
 USTRUCT(BlueprintType)
@@ -165,6 +217,27 @@ struct MMOVEMENT_API FMCharacterMovement_WallRunRuntimeData
 
 	UPROPERTY(VisibleAnywhere)
 	FMCharacterMovement_WallRunSurfaceInfo SurfaceInfoOld = FMCharacterMovement_WallRunSurfaceInfo();
+
+	UPROPERTY(VisibleAnywhere)
+	int32 FramesSinceFullSweep = 0;
+
+	// How many times surface was re-validated on the previous component without a full world sweep
+	UPROPERTY(VisibleAnywhere)
+	int32 SurfaceRevalidationSuccessCount = 0;
+
+	UPROPERTY(VisibleAnywhere)
+	int32 FullSweepCount = 0;
+
+	// Rail wall run is attached to, nullptr when following the wall by sensing
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UMWallRunRailComponent> Rail = nullptr;
+
+	UPROPERTY(VisibleAnywhere)
+	float RailDistance = 0;
+
+	// 1 when moving in spline direction, -1 otherwise
+	UPROPERTY(VisibleAnywhere)
+	float RailDirectionSign = 1;
 };
 
 UENUM(BlueprintType)
@@ -189,20 +262,21 @@ public:
 	// UMMovementMode_Base
 	virtual void Initialize_Implementation() override;
 	virtual void Tick_Implementation(float DeltaTime) override;
-	virtual bool CanStart_Implementation(FString& OutFailReason) override;
+	virtual bool CanStart_Implementation(FMMovementMode_FailReason& OutFailReason) override;
 	virtual void Start_Implementation() override;
 	virtual void Phys_Implementation(float DeltaTime, int32 Iterations) override;
 	virtual void End_Implementation() override;
 	virtual bool IsMovingOnGround_Implementation() override;
 	virtual bool IsMovingOnSurface_Implementation() override;
+	virtual int32 GetReservedCustomMovementMode() const override { return CMOVE_WallRun; }
 	// ~ UMMovementMode_Base
 
 
 	UFUNCTION(BlueprintCallable)
 	EMWallRunWallSide GetWallRunWallSide() const;
 
-	UFUNCTION(BlueprintCallable)
-	void ActivateCooldown();
+	virtual void ActivateCooldown() override;
+	virtual bool AllowsMovementSleep() const override;
 
 protected:
 	// UMMovementMode_Base
@@ -213,16 +287,37 @@ protected:
 #endif
 	// ~ UMMovementMode_Base
 
-	virtual bool CanContinue(FString& OutFailReason) const;
+	virtual bool CanContinue(FMMovementMode_FailReason& OutFailReason) const;
 
-	void SweepAndCalculateSurfaceInfo();
+	void SweepAndCalculateSurfaceInfo(float DeltaTime);
+
+	// Traces the component from SurfaceInfo only, returns false if it isn't a valid wall run surface anymore
+	bool RevalidatePreviousSurface();
+
+	// False when the traversal field has no wall run surface for the current location, sensing should be used then
+	bool FindSurfaceInTraversalField(FMCharacterMovement_WallRunSurfaceInfo& OutSurfaceInfo) const;
 
 	FMCharacterMovement_WallRunSurfaceInfo CalculateSurfaceInfo(const TArray<FHitResult>& Hits);
 
+	bool IsAttachedToRail() const { return RuntimeData.Rail != nullptr; }
+
+	// Attaches to the closest rail of the wall owner within RailAttachMaxDistance
+	void TryAttachToRail();
+	void DetachFromRail();
+
+	// Surface info from the rail at RuntimeData.RailDistance, replaces sensing while attached
+	void UpdateSurfaceInfoFromRail();
+
+	// False when rail ended, wall run continues with the regular move then
+	bool MoveAlongRail(float DeltaTime, float VerticalSpeed);
+
 	FVector GetSurfaceNormal() const;
 
 	FVector GetSnapLocation() const;
 
+	// Correction toward OffsetFromWall from the surface, for the given location
+	FVector CalculateWallSnapDelta(const FVector& Location, float DeltaTime) const;
+
 	FVector GetHorizontalDirectionAlongSurfaceFromVelocity() const;
 
 	float GetHorizontalSpeedFromVelocity() const;
@@ -241,4 +336,12 @@ protected:
 	FMCharacterMovement_WallRunRuntimeData RuntimeData;
 
 	FCollisionQueryParams WallDetectionQueryParams;
+
+	FMMovementSurfaceSensor SurfaceSensor;
+
+	// Compiled from WallRunnableSurfaceTag and SurfaceExclusionTags
+	FMMovementSurfaceFilter SurfaceFilter;
+
+	// Compiled from GroundCheckIgnoredSurfaceTag
+	uint64 GroundCheckIgnoredCategoryMask = 0;
 };